@@ -0,0 +1,168 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  struct binary_output_config {
+
+    /**
+     * Duration of the Pulse signal (0 to 255ms)
+     */
+    std::chrono::milliseconds pulse_duration{0};
+
+    /**
+     * Determine channel polarity, which will be used to interpret further channel values.
+     */
+    bool polarity{};
+
+    /**
+     * Value used by the rio in case nothing provided
+     */
+    bool safety_value{};
+  };
+
+  using binary_input_config = bool;
+  using analog_output_value = uint8_t;
+
+  struct remote_io {
+    /**
+     * Timeout that the device should wait for replies
+     */
+    std::chrono::seconds slc_timeout{10};
+
+    /**
+     * deadtime_timeout in 10th of seconds (1/10)
+     */
+    std::chrono::duration<int, std::deci> deadtime_timeout{10};
+
+    /**
+     * Time for the rio to startup
+     */
+    std::chrono::seconds powerup_timeout{1};
+  };
+
+  /**
+   * Remote IO EY-EM564FXXX : 64 relays, 64 inputs and 16 analog outputs
+   */
+  struct ey_em564fxx : public remote_io {
+
+    ey_em564fxx() : remote_io() {}
+
+    std::array<binary_output_config, 64> relays{};
+    std::array<binary_input_config, 64> inputs{};
+    std::array<analog_output_value, 16> analog_outputs{};
+  };
+
+}
+
+
+/*
+ * -------------------------- USER BINARY SERIALIZATION CODE -----------------------------------
+ */
+
+struct em564_binary_representation {
+  std::array<uint8_t, 64> relay_pulse_durations;
+  bit_column<64> relay_polarities;
+  bit_column<64> relay_safety_values;
+  bit_column<64> input_polarities;
+  std::array<uint8_t, 16> ao_safety_values;
+};
+
+map_to(em564_binary_representation, config::ey_em564fxx,
+  ((relay_pulse_durations, relays, pulse_duration))
+  ((relay_polarities, relays, polarity))
+  ((relay_safety_values, relays, safety_value))
+  ((input_polarities, inputs))
+  ((ao_safety_values, analog_outputs))
+);
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+int main(int argc, char** argv) {
+
+  static_assert(sizeof(em564_binary_representation) == 64 + 3 * 8 + 16, "TOO BIG");
+
+  config::ey_em564fxx module;
+  for (size_t i = 0; i < 64; ++i) {
+    module.relays[i].pulse_duration = std::chrono::milliseconds{(i * 37) % 256};
+    module.relays[i].polarity = (i % 3) == 0;
+    module.relays[i].safety_value = (i % 5) == 1;
+    module.inputs[i] = (i % 7) == 2;
+  }
+  for (size_t i = 0; i < 16; ++i) { module.analog_outputs[i] = static_cast<uint8_t>(i * 11); }
+
+  em564_binary_representation frame{};
+  update_all(frame, module);
+
+  // The layout the device expects, channel per channel.
+  for (size_t i = 0; i < 64; ++i) {
+    assert(frame.relay_pulse_durations[i] == module.relays[i].pulse_duration.count());
+    assert(((frame.relay_polarities.bits[i / 8] >> (i % 8)) & 1) == module.relays[i].polarity);
+    assert(((frame.relay_safety_values.bits[i / 8] >> (i % 8)) & 1) == module.relays[i].safety_value);
+    assert(((frame.input_polarities.bits[i / 8] >> (i % 8)) & 1) == module.inputs[i]);
+  }
+  for (size_t i = 0; i < 16; ++i) { assert(frame.ao_safety_values[i] == module.analog_outputs[i]); }
+
+  config::ey_em564fxx decoded;
+  fill_all(frame, decoded);
+  for (size_t i = 0; i < 64; ++i) {
+    assert(decoded.relays[i].pulse_duration == module.relays[i].pulse_duration);
+    assert(decoded.relays[i].polarity == module.relays[i].polarity);
+    assert(decoded.relays[i].safety_value == module.relays[i].safety_value);
+    assert(decoded.inputs[i] == module.inputs[i]);
+  }
+  assert(decoded.analog_outputs == module.analog_outputs);
+
+  const size_t rounds = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  for (size_t r = 0; r < rounds; ++r) {
+    module.analog_outputs[r % 16] = static_cast<uint8_t>(r);
+    update_all(frame, module);
+    fill_all(frame, decoded);
+  }
+  assert(decoded.analog_outputs == module.analog_outputs);
+
+  std::cout << "64 channels : "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / rounds
+            << "ns per encode + decode" << std::endl;
+
+  return 0;
+}
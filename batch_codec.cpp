@@ -0,0 +1,83 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/batch_codec.hpp>
+
+#include "./em510_binary.hpp"
+
+
+int main(int argc, char** argv) {
+
+  const size_t devices = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100003;
+
+  // Typical fleet : defaults everywhere, a few pulse outputs and inverted inputs here and there.
+  std::vector<em510_binary_representation> frames(devices);
+  for (size_t i = 0; i < devices; ++i) {
+    config::ey_em510fxx cfg;
+    if (i % 50 == 0) { cfg.triac_01.pulse_duration = std::chrono::milliseconds{200}; }
+    if (i % 17 == 0) { cfg.ai_20 = true; }
+    if (i % 5 == 0) { cfg.relay_26.safety_value = true; }
+    cfg.ao_07 = (i % 3 == 0) ? 100 : 0;
+    frames[i] = em510_binary_representation{};
+    update_all(frames[i], cfg);
+  }
+
+  using codec = batch_codec<em510_binary_representation, config::ey_em510fxx>;
+
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  auto compressed = codec::compress(frames.data(), frames.size());
+  auto compress_time = clock::now() - start;
+
+  std::vector<em510_binary_representation> restored;
+  start = clock::now();
+  bool ok = codec::decompress(compressed.data(), compressed.size(), restored, devices);
+  auto decompress_time = clock::now() - start;
+
+  assert(ok);
+  assert(restored.size() == frames.size());
+  assert(std::memcmp(restored.data(), frames.data(), devices * sizeof(em510_binary_representation)) == 0);
+
+  const size_t raw = devices * sizeof(em510_binary_representation);
+  std::cout << devices << " frames : " << raw << " -> " << compressed.size() << " bytes ("
+            << (100.0 * compressed.size() / raw) << "%), compress "
+            << std::chrono::duration_cast<std::chrono::microseconds>(compress_time).count() << "us, decompress "
+            << std::chrono::duration_cast<std::chrono::microseconds>(decompress_time).count() << "us" << std::endl;
+
+  // Truncated and corrupted batches are refused.
+  assert(!codec::decompress(compressed.data(), compressed.size() - 1, restored, devices));
+  compressed[2] ^= 0x01;
+  assert(!codec::decompress(compressed.data(), compressed.size(), restored, devices));
+
+  // Counts the input cannot produce, or above what the caller takes, are refused before any allocation.
+  std::vector<uint8_t> claim{ 'A', 'B' };
+  batch_compression::put_varint(claim, sizeof(em510_binary_representation));
+  batch_compression::put_varint(claim, uint64_t(1) << 36);
+  batch_compression::put_varint(claim, 0);
+  batch_compression::put_varint(claim, 4);
+  claim.insert(claim.end(), { 1, 2, 3, 4 });
+  assert(!codec::decompress(claim.data(), claim.size(), restored, ~size_t(0)));
+  compressed = codec::compress(frames.data(), frames.size());
+  assert(!codec::decompress(compressed.data(), compressed.size(), restored, devices - 1));
+
+  // Random frames still round trip.
+  for (size_t n : {0, 1, 15, 16, 17, 1000}) {
+    std::vector<em510_binary_representation> noise(n);
+    for (size_t b = 0; b < n * sizeof(em510_binary_representation); ++b) {
+      reinterpret_cast<uint8_t*>(noise.data())[b] = static_cast<uint8_t>(std::rand());
+    }
+    auto packed = codec::compress(noise.data(), noise.size());
+    assert(codec::decompress(packed.data(), packed.size(), restored, n));
+    assert(restored.size() == n);
+    assert(n == 0 || std::memcmp(restored.data(), noise.data(), n * sizeof(em510_binary_representation)) == 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/bulk_convert.hpp>
+
+#include "./em510_binary.hpp"
+
+
+int main(int argc, char** argv) {
+
+  const size_t devices = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 500000;
+
+  std::vector<config::ey_em510fxx> fleet(devices);
+  for (size_t i = 0; i < devices; ++i) {
+    fleet[i].triac_01.pulse_duration = std::chrono::milliseconds{i % 256};
+    fleet[i].relay_26.polarity = (i % 7) == 0;
+    fleet[i].triac_05.safety_value = (i % 3) == 0;
+    fleet[i].ai_20 = (i % 2) == 0;
+    fleet[i].ao_11 = static_cast<uint8_t>(i * 31);
+  }
+
+  using clock = std::chrono::steady_clock;
+  auto ms = [](clock::duration d) { return std::chrono::duration_cast<std::chrono::milliseconds>(d).count(); };
+
+  std::vector<em510_binary_representation> reference(devices);
+  auto start = clock::now();
+  for (size_t i = 0; i < devices; ++i) {
+    reference[i] = em510_binary_representation{};
+    update_all(reference[i], fleet[i]);
+  }
+  std::cout << "single threaded : " << ms(clock::now() - start) << "ms" << std::endl;
+
+  // At least 4 workers, so that stealing is exercised even on small machines.
+  work_stealing_pool pool{ std::max(4u, std::thread::hardware_concurrency()) };
+
+  std::vector<em510_binary_representation> frames(devices);
+  start = clock::now();
+  bulk_encode(pool, fleet.data(), fleet.size(), frames.data());
+  std::cout << pool.size() << " workers : " << ms(clock::now() - start) << "ms" << std::endl;
+
+  assert(std::memcmp(frames.data(), reference.data(), devices * sizeof(em510_binary_representation)) == 0);
+
+  std::vector<config::ey_em510fxx> decoded(devices);
+  bulk_decode(pool, frames.data(), frames.size(), decoded.data());
+  for (size_t i = 0; i < devices; ++i) {
+    assert(decoded[i].triac_01.pulse_duration == fleet[i].triac_01.pulse_duration);
+    assert(decoded[i].relay_26.polarity == fleet[i].relay_26.polarity);
+    assert(decoded[i].triac_05.safety_value == fleet[i].triac_05.safety_value);
+    assert(decoded[i].ai_20 == fleet[i].ai_20);
+    assert(decoded[i].ao_11 == fleet[i].ao_11);
+  }
+
+  // No worker asked : the calling thread alone, same frames.
+  work_stealing_pool alone{ 0 };
+  assert(alone.size() == 1);
+  std::vector<em510_binary_representation> alone_frames(devices);
+  bulk_encode(alone, fleet.data(), fleet.size(), alone_frames.data());
+  assert(std::memcmp(alone_frames.data(), reference.data(), devices * sizeof(em510_binary_representation)) == 0);
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include <chrono>
+#include <boost/endian/buffers.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/byte_order.hpp>
+
+using namespace boost::endian;
+
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  /**
+   * Three phases energy meter
+   */
+  struct energy_meter {
+    /**
+     * Counters in Wh and varh
+     */
+    uint32_t active_import{};
+    uint32_t active_export{};
+    uint32_t reactive_import{};
+    uint32_t reactive_export{};
+
+    /**
+     * Phase voltages in 1/10 V, currents in mA
+     */
+    uint16_t voltage_l1{};
+    uint16_t voltage_l2{};
+    uint16_t voltage_l3{};
+    uint16_t current_l1{};
+    uint16_t current_l2{};
+    uint16_t current_l3{};
+
+    uint8_t address{};
+
+    /**
+     * Time since the meter started
+     */
+    std::chrono::seconds uptime{0};
+  };
+
+}
+
+
+
+
+/*
+ * -------------------------- USER BINARY SERIALIZATION CODE -----------------------------------
+ */
+
+/**
+ * The meter sends its readings big endian.
+ */
+struct energy_meter_frame {
+  big_uint32_buf_t active_import;
+  big_uint32_buf_t active_export;
+  big_uint32_buf_t reactive_import;
+  big_uint32_buf_t reactive_export;
+
+  big_uint16_buf_t voltage_l1;
+  big_uint16_buf_t voltage_l2;
+  big_uint16_buf_t voltage_l3;
+  big_uint16_buf_t current_l1;
+  big_uint16_buf_t current_l2;
+  big_uint16_buf_t current_l3;
+
+  big_uint8_buf_t address;
+  big_uint32_buf_t uptime;
+};
+
+map_to(energy_meter_frame, config::energy_meter,
+  ((active_import, active_import))
+  ((active_export, active_export))
+  ((reactive_import, reactive_import))
+  ((reactive_export, reactive_export))
+  ((voltage_l1, voltage_l1))
+  ((voltage_l2, voltage_l2))
+  ((voltage_l3, voltage_l3))
+  ((current_l1, current_l1))
+  ((current_l2, current_l2))
+  ((current_l3, current_l3))
+  ((address, address))
+  ((uptime, uptime))
+);
+
+/**
+ * The same readings as our gateway stores them, little endian.
+ */
+struct energy_meter_record {
+  little_uint32_buf_t active_import;
+  little_uint32_buf_t active_export;
+  little_uint32_buf_t reactive_import;
+  little_uint32_buf_t reactive_export;
+
+  little_uint16_buf_t voltage_l1;
+  little_uint16_buf_t voltage_l2;
+  little_uint16_buf_t voltage_l3;
+  little_uint16_buf_t current_l1;
+  little_uint16_buf_t current_l2;
+  little_uint16_buf_t current_l3;
+};
+
+map_to(energy_meter_record, config::energy_meter,
+  ((active_import, active_import))
+  ((active_export, active_export))
+  ((reactive_import, reactive_import))
+  ((reactive_export, reactive_export))
+  ((voltage_l1, voltage_l1))
+  ((voltage_l2, voltage_l2))
+  ((voltage_l3, voltage_l3))
+  ((current_l1, current_l1))
+  ((current_l2, current_l2))
+  ((current_l3, current_l3))
+);
+
+static_assert(copy_plan<energy_meter_frame, config::energy_meter>::layout == frame_class::mixed,
+              "uptime changes type");
+static_assert(copy_plan<energy_meter_frame, config::energy_meter>::runs.count == 3,
+              "counters, then voltages and currents, then the address");
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static_assert(copy_plan<energy_meter_record, config::energy_meter>::layout == frame_class::native, "a blob");
+static_assert(copy_plan<energy_meter_record, config::energy_meter>::runs.count == 1, "one memcpy");
+#endif
+
+
+
+template <class Binary, class Config>
+void print_plan(const char* name) {
+  using plan = copy_plan<Binary, Config>;
+  static const char* const layouts[] = { "native", "swapped", "mixed" };
+  static const char* const kinds[] = { "transform", "copy", "swap" };
+  std::cout << name << " : " << layouts[static_cast<int>(plan::layout)] << "\n";
+  for (size_t r = 0; r < plan::runs.count; ++r) {
+    const auto& run = plan::runs.runs[r];
+    std::cout << "  " << kinds[static_cast<int>(run.kind)] << " " << run.size << " bytes from " << run.src
+              << " to " << run.dest << " by " << run.element << "\n";
+  }
+}
+
+config::energy_meter reading(size_t k) {
+  config::energy_meter m;
+  m.active_import = static_cast<uint32_t>(k * 1000 + 7);
+  m.active_export = static_cast<uint32_t>(k * 3);
+  m.reactive_import = 0xDEAD0000u + static_cast<uint32_t>(k % 65536);
+  m.voltage_l1 = 2301;
+  m.voltage_l3 = static_cast<uint16_t>(2290 + k % 20);
+  m.current_l2 = static_cast<uint16_t>(k % 60000);
+  m.address = static_cast<uint8_t>(k);
+  m.uptime = std::chrono::seconds{k * 60};
+  return m;
+}
+
+bool same_reading(const config::energy_meter& a, const config::energy_meter& b) {
+  return a.active_import == b.active_import && a.active_export == b.active_export &&
+    a.reactive_import == b.reactive_import && a.reactive_export == b.reactive_export &&
+    a.voltage_l1 == b.voltage_l1 && a.voltage_l3 == b.voltage_l3 && a.current_l2 == b.current_l2 &&
+    a.address == b.address && a.uptime == b.uptime;
+}
+
+int main(int argc, char** argv) {
+  using frame_mapping = member_mapping<energy_meter_frame, config::energy_meter>;
+  print_plan<energy_meter_frame, config::energy_meter>("energy_meter_frame");
+  print_plan<energy_meter_record, config::energy_meter>("energy_meter_record");
+
+  const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+  // A window which stays in cache, decoded count times : the decoding, not the memory, is measured.
+  const size_t window = 4096;
+  std::vector<energy_meter_frame> frames(window);
+  for (size_t k = 0; k < window; ++k) { update_all(frames[k], reading(k)); }
+
+  // The planned encoding is the per field one.
+  energy_meter_frame per_field;
+  update_all(per_field, reading(1234), frame_mapping::mappings{});
+  assert(std::memcmp(&per_field, &frames[1234], sizeof(energy_meter_frame)) == 0);
+  assert(frames[0].active_import.value() == 7 && frames[window - 1].address.value() == uint8_t(window - 1));
+
+  std::vector<config::energy_meter> decoded(window);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) {
+    fill_all(frames[k % window], decoded[k % window], frame_mapping::mappings{});
+  }
+  auto by_field = std::chrono::steady_clock::now() - start;
+  for (size_t k = 0; k < window; ++k) { assert(same_reading(decoded[k], reading(k))); }
+
+  decoded.assign(window, config::energy_meter{});
+  start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) { fill_all(frames[k % window], decoded[k % window]); }
+  auto planned = std::chrono::steady_clock::now() - start;
+  for (size_t k = 0; k < window; ++k) { assert(same_reading(decoded[k], reading(k))); }
+
+  // Stored records are a blob of the model counters.
+  energy_meter_record record;
+  update_all(record, decoded[window / 2]);
+  config::energy_meter back;
+  fill_all(record, back);
+  assert(back.active_import == decoded[window / 2].active_import && back.current_l2 == decoded[window / 2].current_l2);
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << "field by field : " << std::chrono::duration_cast<ns>(by_field).count() / double(count)
+            << " ns per frame, planned : " << std::chrono::duration_cast<ns>(planned).count() / double(count)
+            << " ns per frame" << std::endl;
+  return 0;
+}
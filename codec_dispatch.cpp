@@ -0,0 +1,78 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/codec_dispatch.hpp>
+
+#include "./em510_binary.hpp"
+
+
+int main(int argc, char** argv) {
+
+  const size_t devices = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100003;
+
+  std::vector<config::ey_em510fxx> fleet(devices);
+  std::unique_ptr<bool[]> column{new bool[devices]};
+  for (size_t i = 0; i < devices; ++i) {
+    fleet[i].triac_05.pulse_duration = std::chrono::milliseconds{i % 256};
+    fleet[i].relay_25.polarity = (i % 7) == 0;
+    fleet[i].ai_23 = (i * 2654435761u) % 3 == 0;
+    fleet[i].ao_07 = static_cast<uint8_t>(i);
+    column[i] = fleet[i].ai_23;
+  }
+
+  auto& bound = codec<em510_binary_representation, config::ey_em510fxx>();
+  std::cout << "bound to " << isa_name(bound.bound) << std::endl;
+
+  using kernels = codec_kernels<em510_binary_representation, config::ey_em510fxx>;
+  auto reference = kernels::for_isa(isa::scalar);
+
+  std::vector<em510_binary_representation> expected_frames(devices);
+  reference.encode_n(fleet.data(), devices, expected_frames.data());
+  std::vector<uint8_t> expected_bits((devices + 7) / 8);
+  reference.pack_bits(column.get(), devices, expected_bits.data());
+
+  using clock = std::chrono::steady_clock;
+  for (isa i : {isa::scalar, isa::sse42, isa::avx2, isa::avx512}) {
+    if (i > detected_isa()) { break; }
+    auto k = kernels::for_isa(i);
+
+    std::vector<em510_binary_representation> frames(devices);
+    auto start = clock::now();
+    k.encode_n(fleet.data(), devices, frames.data());
+    auto encode_time = clock::now() - start;
+    assert(std::memcmp(frames.data(), expected_frames.data(), devices * sizeof(em510_binary_representation)) == 0);
+
+    std::vector<config::ey_em510fxx> decoded(devices);
+    k.decode_n(frames.data(), devices, decoded.data());
+    for (size_t d = 0; d < devices; ++d) {
+      assert(decoded[d].triac_05.pulse_duration == fleet[d].triac_05.pulse_duration);
+      assert(decoded[d].relay_25.polarity == fleet[d].relay_25.polarity);
+      assert(decoded[d].ao_07 == fleet[d].ao_07);
+    }
+
+    std::vector<uint8_t> bits((devices + 7) / 8);
+    start = clock::now();
+    k.pack_bits(column.get(), devices, bits.data());
+    auto pack_time = clock::now() - start;
+    assert(bits == expected_bits);
+
+    std::unique_ptr<bool[]> unpacked{new bool[devices]};
+    k.unpack_bits(bits.data(), devices, unpacked.get());
+    assert(std::memcmp(unpacked.get(), column.get(), devices) == 0);
+
+    std::cout << isa_name(i) << " : encode " << std::chrono::duration_cast<std::chrono::microseconds>(encode_time).count()
+              << "us, pack " << std::chrono::duration_cast<std::chrono::microseconds>(pack_time).count() << "us"
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -1 +1 @@
-clang++-4.0 -std=c++1y ecolink510.cpp -I /home/daminetreg/.hunter/_Base/f922960/847d88b/8ee437b/Install/include/
+cmake -S . -B build "$@" && cmake --build build -j && ctest --test-dir build --output-on-failure
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/conversion_cache.hpp>
+
+#include "./em510_binary.hpp"
+
+
+int main(int argc, char** argv) {
+
+  // A commissioning run : 20000 modules, but only a few distinct configs among them.
+  constexpr size_t modules = 20000;
+  constexpr size_t distinct = 40;
+
+  std::vector<config::ey_em510fxx> building(modules);
+  for (size_t i = 0; i < modules; ++i) {
+    size_t kind = (i * 7919) % distinct;
+    building[i].triac_01.pulse_duration = std::chrono::milliseconds{kind};
+    building[i].relay_26.polarity = (kind % 2) == 0;
+    building[i].ao_09 = static_cast<uint8_t>(kind * 3);
+    // Not mapped to the frame : must not prevent hits.
+    building[i].slc_timeout = std::chrono::seconds{static_cast<long>(i % 13)};
+  }
+
+  conversion_cache<em510_binary_representation, config::ey_em510fxx> cache{256};
+
+  for (auto& cfg : building) {
+    const em510_binary_representation& cached = cache.encode(cfg);
+
+    em510_binary_representation expected{};
+    update_all(expected, cfg);
+    assert(std::memcmp(&cached, &expected, sizeof(expected)) == 0);
+  }
+
+  std::cout << "key " << mapped_key<em510_binary_representation, config::ey_em510fxx>::size << " bytes, "
+            << cache.hits() << " hits, " << cache.misses() << " misses, "
+            << cache.evictions() << " evictions" << std::endl;
+
+  assert(cache.hits() + cache.misses() == modules);
+  assert(cache.misses() < 2 * distinct);
+
+  // More distinct configs than the capacity : memory stays bounded, CLOCK evicts.
+  conversion_cache<em510_binary_representation, config::ey_em510fxx> small{8};
+  for (size_t i = 0; i < 1000; ++i) {
+    config::ey_em510fxx cfg;
+    cfg.ao_11 = static_cast<uint8_t>(i);
+    cfg.ao_07 = static_cast<uint8_t>(i >> 8);
+    small.encode(cfg);
+  }
+  assert(small.capacity() == 8);
+  assert(small.misses() == 1000 && small.evictions() == 1000 - 8);
+
+  return 0;
+}
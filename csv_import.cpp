@@ -0,0 +1,79 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <system_error>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/csv_import.hpp>
+
+#include "./em510_binary.hpp"
+
+#include <unistd.h>
+
+
+int main(int argc, char** argv) {
+  using importer = csv::importer<em510_binary_representation, config::ey_em510fxx>;
+
+  const char sample[] =
+    "triac_01.pulse_duration,triac_01.polarity,relay_27.safety_value,ai_22,ao_09,location\r\n"
+    "20,true,1,0,42,floor 1\r\n"
+    "255,false,0,1,7,floor 2\r\n"
+    "30,maybe,0,1,7,floor 3\r\n";
+
+  std::vector<config::ey_em510fxx> configs;
+  auto result = importer::import(sample, sizeof(sample) - 1, configs);
+  assert(result.rows == 3 && result.rejected_rows == 1 && result.first_rejected_row == 3);
+  assert(result.ignored_columns.size() == 1 && result.ignored_columns[0] == "location");
+  assert(configs.size() == 2);
+  assert(configs[0].triac_01.pulse_duration == std::chrono::milliseconds{20} && configs[0].triac_01.polarity);
+  assert(configs[0].relay_27.safety_value && !configs[0].ai_22 && configs[0].ao_09 == 42);
+  assert(configs[1].triac_01.pulse_duration == std::chrono::milliseconds{255} && configs[1].ai_22);
+
+  const size_t rows = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  char path[] = "/tmp/annotate-import-XXXXXX";
+  int fd = ::mkstemp(path);
+  assert(fd >= 0);
+  {
+    std::string file =
+      "triac_01.pulse_duration,triac_03.pulse_duration,triac_05.pulse_duration,"
+      "relay_25.pulse_duration,relay_26.pulse_duration,relay_27.pulse_duration,"
+      "triac_01.polarity,triac_03.polarity,triac_05.polarity,relay_25.polarity,relay_26.polarity,relay_27.polarity,"
+      "ai_18,ai_20,ai_22,ai_23,ao_07,ao_09,ao_11,"
+      "triac_01.safety_value,triac_03.safety_value,triac_05.safety_value,"
+      "relay_25.safety_value,relay_26.safety_value,relay_27.safety_value\n";
+    for (size_t r = 0; r < rows; ++r) {
+      for (size_t c = 0; c < 6; ++c) { file += std::to_string((r + c) % 256) + ","; }
+      for (size_t c = 0; c < 10; ++c) { file += ((r >> c) & 1) ? "true," : "false,"; }
+      for (size_t c = 0; c < 3; ++c) { file += std::to_string((r * 7 + c) % 256) + ","; }
+      for (size_t c = 0; c < 6; ++c) { file += ((r >> c) & 1) ? "1" : "0"; file += (c == 5) ? "\n" : ","; }
+    }
+    ssize_t written = ::write(fd, file.data(), file.size());
+    assert(written == static_cast<ssize_t>(file.size()));
+    ::close(fd);
+  }
+
+  configs.clear();
+  auto start = std::chrono::steady_clock::now();
+  result = importer::import(path, configs);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  ::unlink(path);
+
+  assert(result.rows == rows && result.rejected_rows == 0 && result.ignored_columns.empty());
+  assert(configs.size() == rows);
+  for (size_t r = 0; r < rows; r += 9973) {
+    assert(configs[r].relay_26.pulse_duration == std::chrono::milliseconds{(r + 4) % 256});
+    assert(configs[r].ai_23 == (((r >> 9) & 1) != 0));
+    assert(configs[r].ao_11 == (r * 7 + 2) % 256);
+    assert(configs[r].relay_25.safety_value == (((r >> 3) & 1) != 0));
+  }
+
+  std::cout << "imported " << result.rows << " rows in " << elapsed.count() << "ms" << std::endl;
+  return 0;
+}
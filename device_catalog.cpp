@@ -0,0 +1,156 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/device_catalog.hpp>
+
+#include "./em510_binary.hpp"
+
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  /**
+   * Remote IO EY-EM522FXXX : relay only module
+   */
+  struct ey_em522fxx : public remote_io {
+
+    ey_em522fxx() : remote_io() {}
+
+    binary_output_config relay_01{};
+    binary_output_config relay_02{};
+    binary_output_config relay_03{};
+    binary_output_config relay_04{};
+
+    binary_input_config di_05{};
+    binary_input_config di_06{};
+  };
+
+}
+
+
+struct em522_binary_representation {
+
+  uint8_t relay_01_pulse_duration;
+  uint8_t relay_02_pulse_duration;
+  uint8_t relay_03_pulse_duration;
+  uint8_t relay_04_pulse_duration;
+
+  struct alignas(1_byte) {
+    bool relay_01                             : 1_bits;
+    bool relay_02                             : 1_bits;
+    bool relay_03                             : 1_bits;
+    bool relay_04                             : 1_bits;
+
+    bool di_05                                : 1_bits;
+    bool di_06                                : 1_bits;
+
+    uint8_t reserved_end                      : 2_bits;
+  } polarities;
+
+  struct alignas(1_byte) {
+    bool relay_01                             : 1_bits;
+    bool relay_02                             : 1_bits;
+    bool relay_03                             : 1_bits;
+    bool relay_04                             : 1_bits;
+
+    uint8_t reserved_end                      : 4_bits;
+  } bo_safety_values;
+};
+
+map_to(em522_binary_representation, config::ey_em522fxx,
+  ((relay_01_pulse_duration, relay_01.pulse_duration))
+  ((relay_02_pulse_duration, relay_02.pulse_duration))
+  ((relay_03_pulse_duration, relay_03.pulse_duration))
+  ((relay_04_pulse_duration, relay_04.pulse_duration))
+  ((polarities.relay_01, relay_01.polarity))
+  ((polarities.relay_02, relay_02.polarity))
+  ((polarities.relay_03, relay_03.polarity))
+  ((polarities.relay_04, relay_04.polarity))
+  ((polarities.di_05, di_05))
+  ((polarities.di_06, di_06))
+  ((bo_safety_values.relay_01, relay_01.safety_value))
+  ((bo_safety_values.relay_02, relay_02.safety_value))
+  ((bo_safety_values.relay_03, relay_03.safety_value))
+  ((bo_safety_values.relay_04, relay_04.safety_value))
+);
+
+
+/*
+ * -------------------------- USER device catalog -----------------------------------
+ */
+
+register_device(0x0A, em510_binary_representation, config::ey_em510fxx)
+register_device(0x16, em522_binary_representation, config::ey_em522fxx)
+
+using bus_catalog = device_catalog<0x1F>;
+
+
+int main(int argc, char** argv) {
+
+  static_assert(sizeof(em510_binary_representation) == 12, "TOO BIG");
+  static_assert(sizeof(em522_binary_representation) == 6, "TOO BIG");
+
+  config::ey_em510fxx em510;
+  em510.triac_01.safety_value = true;
+  em510.triac_03.polarity = true;
+  em510.relay_26.pulse_duration = std::chrono::milliseconds{200};
+  em510.ai_23 = true;
+  em510.ao_09 = 42;
+
+  config::ey_em522fxx em522;
+  em522.relay_03.polarity = true;
+  em522.relay_04.pulse_duration = std::chrono::milliseconds{15};
+  em522.di_06 = true;
+
+  // A bus is a mix of module types, the dispatch happens per frame on the device id only.
+  struct bus_slot { device_id id; const void* config; };
+  std::vector<bus_slot> bus { {0x0A, &em510}, {0x16, &em522}, {0x0A, &em510}, {0x03, &em510} };
+
+  std::vector<char> frames(bus.size() * 16, char{});
+  std::vector<size_t> sizes;
+  size_t offset = 0;
+  for (auto& slot : bus) {
+    auto written = bus_catalog::encode(slot.id, slot.config, frames.data() + offset, frames.size() - offset);
+    sizes.push_back(written);
+    offset += written;
+  }
+
+  assert(sizes[0] == sizeof(em510_binary_representation));
+  assert(sizes[1] == sizeof(em522_binary_representation));
+  assert(sizes[3] == 0 && !bus_catalog::is_registered(0x03));
+  assert(!bus_catalog::is_registered(0xFF));
+
+  // A buffer too short for the frame of the device is left alone.
+  std::array<char, sizeof(em510_binary_representation) - 1> short_frame{};
+  assert(bus_catalog::encode(0x0A, &em510, short_frame.data(), short_frame.size()) == 0);
+  assert(bus_catalog::encode(0x16, &em522, short_frame.data(), short_frame.size()) == sizes[1]);
+
+  config::ey_em510fxx em510_decoded;
+  config::ey_em522fxx em522_decoded;
+  assert(bus_catalog::decode(0x0A, frames.data(), sizes[0], &em510_decoded));
+  assert(bus_catalog::decode(0x16, frames.data() + sizes[0], sizes[1], &em522_decoded));
+  assert(!bus_catalog::decode(0x0A, frames.data(), 3, &em510_decoded));
+
+  assert(em510_decoded.triac_01.safety_value == em510.triac_01.safety_value);
+  assert(em510_decoded.triac_03.polarity == em510.triac_03.polarity);
+  assert(em510_decoded.relay_26.pulse_duration == em510.relay_26.pulse_duration);
+  assert(em510_decoded.ai_23 == em510.ai_23);
+  assert(em510_decoded.ao_09 == em510.ao_09);
+
+  assert(em522_decoded.relay_03.polarity == em522.relay_03.polarity);
+  assert(em522_decoded.relay_04.pulse_duration == em522.relay_04.pulse_duration);
+  assert(em522_decoded.di_06 == em522.di_06);
+
+  std::cout << "encoded " << offset << " bytes for " << bus.size() << " bus slots" << std::endl;
+
+  return 0;
+}
@@ -4,6 +4,7 @@
 #include <boost/endian/buffers.hpp>  // see Synopsis below
 #include <boost/static_assert.hpp>
 #include <pre/bytes/utils.hpp>
+#include <annotate/frame_pool.hpp>
 
 #include <chrono>
 
@@ -361,15 +362,15 @@ int main(int, char* [])
   mycfg.ai_23 = true;
   //mycfg.slc_timeout = std::chrono::seconds{15}; 
 
-  em510_binary_representation h{mycfg};
+  // The frame is encoded in place, in a slot of the pool.
+  auto buffer = frame_buffer<em510_binary_representation>::acquire();
+  buffer.frame() = em510_binary_representation{mycfg};
 
-  std::string buffer (sizeof(h), char{});
-  std::memcpy(const_cast<char*>(buffer.data()), &h, sizeof(h));
-
-  std::cout << sizeof(h) << "-" << buffer.size() << " - " << pre::bytes::to_hexstring(buffer) << std::endl;
+  std::cout << buffer.size() << " - "
+            << pre::bytes::to_hexstring(std::string(buffer.data(), buffer.size())) << std::endl;
 
   em510_binary_representation deser{mycfg};
-  std::memcpy(&deser, buffer.data(), sizeof(h));
+  std::memcpy(&deser, buffer.data(), buffer.size());
   
   config::ey_em510fxx desered = deser;
 
@@ -396,7 +397,7 @@ int main(int, char* [])
     return 1;
   }
 
-  if (std::fwrite(&h, sizeof(em510_binary_representation), 1, fi)!= 1)
+  if (std::fwrite(buffer.data(), buffer.size(), 1, fi)!= 1)
   {
     std::cout << "write failure for " << filename << '\n';
     return 1;
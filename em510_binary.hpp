@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+
+#include "./em510_model.hpp"
+
+/*
+ * -------------------------- USER BINARY SERIALIZATION CODE -----------------------------------
+ */
+
+struct em510_binary_representation {
+
+  uint8_t triac_01_pulse_duration;
+  uint8_t triac_03_pulse_duration;
+  uint8_t triac_05_pulse_duration;
+
+  uint8_t relay_25_pulse_duration;
+  uint8_t relay_26_pulse_duration;
+  uint8_t relay_27_pulse_duration;
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+    bool triac_05                             : 1_bits;
+
+    bool relay_25                             : 1_bits;
+    bool relay_26                             : 1_bits;
+    bool relay_27                             : 1_bits;
+  } bo_polarities;
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool ai_18                                : 1_bits;
+    bool ai_20                                : 1_bits;
+    bool ai_22                                : 1_bits;
+    bool ai_23                                : 1_bits;
+
+    uint8_t reserved_end                      : 2_bits;
+  } bi_polarities;
+
+  uint8_t ao_07_safety_value;
+  uint8_t ao_09_safety_value;
+  uint8_t ao_11_safety_value;
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+    bool triac_05                             : 1_bits;
+
+    bool relay_25                             : 1_bits;
+    bool relay_26                             : 1_bits;
+    bool relay_27                             : 1_bits;
+  } bo_safety_values;
+};
+
+map_to(em510_binary_representation, config::ey_em510fxx,
+  ((triac_01_pulse_duration, triac_01.pulse_duration))
+  ((triac_03_pulse_duration, triac_03.pulse_duration))
+  ((triac_05_pulse_duration, triac_05.pulse_duration))
+  ((relay_25_pulse_duration, relay_25.pulse_duration))
+  ((relay_26_pulse_duration, relay_26.pulse_duration))
+  ((relay_27_pulse_duration, relay_27.pulse_duration))
+  ((bo_polarities.triac_01, triac_01.polarity))
+  ((bo_polarities.triac_03, triac_03.polarity))
+  ((bo_polarities.triac_05, triac_05.polarity))
+  ((bo_polarities.relay_25, relay_25.polarity))
+  ((bo_polarities.relay_26, relay_26.polarity))
+  ((bo_polarities.relay_27, relay_27.polarity))
+  ((bi_polarities.ai_18, ai_18))
+  ((bi_polarities.ai_20, ai_20))
+  ((bi_polarities.ai_22, ai_22))
+  ((bi_polarities.ai_23, ai_23))
+  ((ao_07_safety_value, ao_07))
+  ((ao_09_safety_value, ao_09))
+  ((ao_11_safety_value, ao_11))
+  ((bo_safety_values.triac_01, triac_01.safety_value))
+  ((bo_safety_values.triac_03, triac_03.safety_value))
+  ((bo_safety_values.triac_05, triac_05.safety_value))
+  ((bo_safety_values.relay_25, relay_25.safety_value))
+  ((bo_safety_values.relay_26, relay_26.safety_value))
+  ((bo_safety_values.relay_27, relay_27.safety_value))
+);
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <ratio>
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  struct binary_output_config {
+
+    /**
+     * Duration of the Pulse signal (0 to 255ms)
+     */
+    std::chrono::milliseconds pulse_duration{0};
+
+    /**
+     * Determine channel polarity, which will be used to interpret further channel values.
+     */
+    bool polarity{};
+
+    /**
+     * Value used by the rio in case nothing provided
+     */
+    bool safety_value{};
+  };
+
+  using binary_input_config = bool;
+  using analog_output_value = uint8_t;
+
+  struct remote_io {
+    /**
+     * Timeout that the device should wait for replies
+     */
+    std::chrono::seconds slc_timeout{10};
+
+    /**
+     * deadtime_timeout in 10th of seconds (1/10)
+     */
+    std::chrono::duration<int, std::deci> deadtime_timeout{10};
+
+    /**
+     * Time for the rio to startup
+     */
+    std::chrono::seconds powerup_timeout{1};
+  };
+
+  /**
+   * Remote IO EY-EM510FXXX
+   *
+   * ![Mapping EY-EM510FXXX](../doc/diagrams/ey_em510fxx.png)
+   */
+  struct ey_em510fxx : public remote_io {
+
+    ey_em510fxx() : remote_io() {}
+
+    binary_output_config triac_01{};
+    binary_output_config triac_03{};
+    binary_output_config triac_05{};
+
+    binary_output_config relay_25{};
+    binary_output_config relay_26{};
+    binary_output_config relay_27{};
+
+    binary_input_config ai_18{};
+    binary_input_config ai_20{};
+    binary_input_config ai_22{};
+    binary_input_config ai_23{};
+
+    analog_output_value ao_07{};
+    analog_output_value ao_09{};
+    analog_output_value ao_11{};
+
+  };
+
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/frame_pool.hpp>
+
+#include "./em510_binary.hpp"
+
+
+int main(int argc, char** argv) {
+
+  config::ey_em510fxx mycfg;
+  mycfg.triac_01.safety_value = true;
+  mycfg.triac_03.polarity = true;
+  mycfg.ai_23 = true;
+
+  {
+    auto buffer = encode<em510_binary_representation>(mycfg);
+
+    std::cout << buffer.size() << " - ";
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      std::cout << std::hex << std::setw(2) << std::setfill('0') << int(static_cast<uint8_t>(buffer.data()[i]));
+    }
+    std::cout << std::dec << std::endl;
+
+    config::ey_em510fxx desered = decode<config::ey_em510fxx>(buffer);
+    assert(desered.triac_01.safety_value == mycfg.triac_01.safety_value);
+    assert(desered.triac_03.polarity == mycfg.triac_03.polarity);
+    assert(desered.ai_23 == mycfg.ai_23);
+  }
+
+  // Encoders on some threads, the frames are released on another thread : the slots travel back through
+  // the shared stack, and the arena stops growing once the pool is warm.
+  constexpr size_t producers = 4;
+  constexpr size_t frames_per_producer = 200000;
+  constexpr size_t in_flight = 256;
+
+  std::mutex handoff_mutex;
+  std::vector<frame_buffer<em510_binary_representation>> handoff;
+  std::atomic<size_t> done{0};
+  std::atomic<size_t> released{0};
+
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      auto buffer = frame_buffer<em510_binary_representation>::acquire();
+      for (size_t i = 0; i < frames_per_producer; ++i) {
+        config::ey_em510fxx cfg;
+        cfg.ao_07 = static_cast<uint8_t>(p + i);
+        encode(cfg, buffer);
+        assert(decode<config::ey_em510fxx>(buffer).ao_07 == cfg.ao_07);
+
+        if (i % 16 == 0) {
+          std::lock_guard<std::mutex> lock(handoff_mutex);
+          if (handoff.size() < in_flight) {
+            handoff.push_back(std::move(buffer));
+            buffer = frame_buffer<em510_binary_representation>::acquire();
+          }
+        }
+      }
+      ++done;
+    });
+  }
+
+  threads.emplace_back([&]() {
+    for (;;) {
+      std::vector<frame_buffer<em510_binary_representation>> to_release;
+      { std::lock_guard<std::mutex> lock(handoff_mutex);
+        to_release.swap(handoff);
+      }
+      released += to_release.size();
+      if (to_release.empty() && done == producers) { break; }
+    }
+  });
+
+  for (auto& t : threads) { t.join(); }
+
+  auto& pool = frame_pool<em510_binary_representation>::instance();
+  std::cout << "released " << released << " frames across threads, arena holds "
+            << pool.reserved_slots() << " slots" << std::endl;
+
+  assert(released > 0);
+  assert(pool.reserved_slots() < (producers + 2) * 64 + in_flight + producers);
+
+  return 0;
+}
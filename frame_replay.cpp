@@ -0,0 +1,128 @@
+#include <iostream>
+#include <utility>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <unistd.h>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/observer.hpp>
+#include <annotate/model_compare.hpp>
+#include <annotate/frame_log.hpp>
+#include <annotate/replay.hpp>
+
+#include "./em510_binary.hpp"
+
+
+/*
+ * Frame replay
+ *
+ *   frame_replay [count] [log] [max|recorded]
+ *
+ * Replays a frame log through decode, diff and notify : a field_observer with the subscriptions of a gateway, the
+ * states of every device. A log which does not exist yet is first recorded with count frames of a synthetic
+ * polling cycle ; without a log, such a capture is recorded in /tmp and removed afterwards. The replay runs twice
+ * at max speed, and must give the same states and notifications both times : it is deterministic. It is then
+ * reported at the given speed, max by default.
+ */
+
+mapped_comparisons(em510_binary_representation, config::ey_em510fxx)
+
+using observer = field_observer<em510_binary_representation, config::ey_em510fxx>;
+using log_type = frame_log<em510_binary_representation>;
+
+/**
+ * A polling cycle over 64 devices, a frame every 20us or so, a field changing in one frame out of 16.
+ */
+void record_capture(const std::string& path, size_t count) {
+  frame_log_writer<em510_binary_representation> writer(path);
+  std::mt19937 random(5);
+  std::vector<config::ey_em510fxx> states(64);
+  uint64_t timestamp = 0;
+  for (size_t k = 0; k < count; ++k) {
+    const uint32_t device = k % states.size();
+    config::ey_em510fxx& cfg = states[device];
+    switch (random() % 64) {
+      case 0: cfg.triac_01.polarity = !cfg.triac_01.polarity; break;
+      case 1: cfg.relay_27.polarity = !cfg.relay_27.polarity; break;
+      case 2: cfg.ao_09 = static_cast<uint8_t>(random()); break;
+      case 3: cfg.ai_22 = !cfg.ai_22; break;
+      default: break;
+    }
+    em510_binary_representation frame;
+    std::memset(&frame, 0, sizeof(em510_binary_representation));
+    update_all(frame, cfg);
+    timestamp += 15000 + random() % 10000;
+    writer.record(device, frame, timestamp);
+  }
+  writer.flush();
+}
+
+struct gateway {
+  observer obs;
+  std::vector<config::ey_em510fxx> states;
+  size_t notifications = 0;
+
+  gateway() {
+    auto count = [this](uint32_t, const config::ey_em510fxx&, const observer::changes&) { ++notifications; };
+    obs.subscribe({ "triac_01.polarity", "relay_27.polarity" }, count);
+    obs.subscribe({ "ao_09" }, count);
+    obs.subscribe({ "ai_22", "triac_01.polarity" }, count);
+  }
+
+  void process(const log_type::record& r) {
+    if (r.device >= states.size()) { states.resize(r.device + 1); }
+    obs.decode(r.device, r.frame, states[r.device]);
+  }
+
+  size_t fingerprint() const {
+    size_t h = notifications;
+    for (const auto& s : states) { h = h * 31 + std::hash<config::ey_em510fxx>{}(s); }
+    return h;
+  }
+};
+
+replay_report replay_through(const log_type& log, replay_speed speed, size_t& fingerprint) {
+  gateway g;
+  const auto report = replay(log.records().data(), log.size(), speed, [&](const log_type::record& r) { g.process(r); });
+  fingerprint = g.fingerprint();
+  return report;
+}
+
+int main(int argc, char** argv) {
+  const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+  const bool temporary = argc <= 2;
+  const std::string path = temporary ? "/tmp/frame_replay-" + std::to_string(::getpid()) + ".log" : argv[2];
+  const replay_speed speed = (argc > 3 && std::string(argv[3]) == "recorded") ? replay_speed::recorded
+                                                                               : replay_speed::max;
+
+  if (temporary || ::access(path.c_str(), F_OK) != 0) { record_capture(path, count); }
+  const log_type log(path);
+  if (temporary) { std::remove(path.c_str()); }
+  assert(log.size() > 0);
+
+  size_t first = 0, second = 0;
+  replay_through(log, replay_speed::max, first);
+  replay_through(log, replay_speed::max, second);
+  assert(first == second);
+
+  size_t fingerprint = 0;
+  const replay_report report = replay_through(log, speed, fingerprint);
+  assert(fingerprint == first && report.latency.count() == log.size());
+  assert(report.latency.percentile(50) <= report.latency.percentile(99));
+  assert(report.latency.percentile(99.9) <= report.latency.max());
+
+  std::cout << report.records << " frames replayed at " << (speed == replay_speed::max ? "max" : "recorded")
+            << " speed, " << report.throughput() << " frames/s\n"
+            << "latency p50 " << report.latency.percentile(50) << " ns, p99 " << report.latency.percentile(99)
+            << " ns, p999 " << report.latency.percentile(99.9) << " ns, max " << report.latency.max() << " ns"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <functional>
+#include <type_traits>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/seq.hpp>
+#include <boost/preprocessor/variadic/to_seq.hpp>
+// annotated() lists every field of a frame, more than the 20 types boost::mpl::list takes by default.
+#ifndef BOOST_MPL_LIMIT_LIST_SIZE
+#define BOOST_MPL_CFG_NO_PREPROCESSED_HEADERS
+#define BOOST_MPL_LIMIT_LIST_SIZE 50
+#endif
+#include <boost/mpl/list.hpp>
+#include <boost/metaparse/string.hpp>
+
+#include "./wire_cast.hpp"
+
+/**
+ * Rationale : The anchor_LINE typedef is made of a METAPARSE_STRING because this way we get an unique type for each
+ *             field, based on their name. We cannot rely on the field member pointer, as it doesn't work for bitfields,
+ *             and our first target for this member mapping library is binary serialization. And we want to map smaller than
+ *             a byte.
+ *
+ */
+
+#define get_annotations_on_each(r, data, elem) , elem
+
+
+#define 📜(field, ...)                                                                                                      \
+  auto get_annotations( BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(field)) ) { \
+                                                                                                                     \
+    return std::make_tuple(                                                                                                         \
+       bool{} BOOST_PP_SEQ_FOR_EACH(get_annotations_on_each, unused,                                                   \
+       BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__) )                    \
+    );                                                                                                               \
+  }
+
+
+#define annotated_on_each(r, data, elem) , BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(elem))
+
+#define annotated(...) \
+  typedef boost::mpl::list< bool \
+    BOOST_PP_SEQ_FOR_EACH(annotated_on_each, unused, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
+  > annotated;
+
+
+struct jsonize {};
+
+
+/**
+ * The annotation mapping a field to a model field. Named annotation_map and annotate_map, so that it does not
+ * collide with the map_to and member_map of member_mapping.hpp.
+ *
+ * bytes is the size of the model field.
+ */
+template<class srcpath, class dstpath>
+struct annotation_map {
+  std::function<srcpath> fill_src;
+  std::function<dstpath> fill_dst;
+  size_t bytes;
+};
+
+template <class T>
+struct is_annotation_map : public std::false_type {};
+
+template <class S, class D>
+struct is_annotation_map<annotation_map<S, D>> : public std::true_type {};
+
+#define annotate_map(srcpath, dsttype, dstpath)                                     \
+  (annotation_map< void( decltype(*this)& src, const dsttype& dst ) , void( decltype(*this)& src, dsttype& dst ) > {\
+    []( decltype(*this)& src, const dsttype& dst ) { src. srcpath = wire_cast<decltype(src. srcpath)>(dst. dstpath); }, \
+    []( decltype(*this)& src, dsttype& dst ) { dst. dstpath = wire_cast<decltype(dst. dstpath)>(src. srcpath); }, \
+    sizeof(std::declval<dsttype&>(). dstpath) \
+  })
+
+
+
+// Easier syntax
+
+#define 📃(field) \
+  field; using BOOST_PP_CAT(anchor_, __LINE__ ) = BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(field)); \
+  auto& BOOST_PP_CAT(get_anchor_, __LINE__ )() { return field; }
+
+
+#define 📒(...) \
+  auto get_annotations( BOOST_PP_CAT(anchor_, __LINE__ ) ) { \
+                                                                                                                     \
+    return std::make_tuple(                                                                                                         \
+       bool{} BOOST_PP_SEQ_FOR_EACH(get_annotations_on_each, unused,                                                   \
+       BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__) )                    \
+    );                                                                                                               \
+  }
+
+#define annotate_mapv3(dsttype, dstpath)                                     \
+  (annotation_map< void( decltype(*this)& src, const dsttype& dst ) , void( decltype(*this)& src, dsttype& dst ) > {\
+    [this]( decltype(*this)&, const dsttype& dst ) { \
+      auto& field = BOOST_PP_CAT(get_anchor_, __LINE__ )(); field = wire_cast<std::decay_t<decltype(field)>>(dst. dstpath); }, \
+    [this]( decltype(*this)&, dsttype& dst ) { \
+      dst. dstpath = wire_cast<decltype(dst. dstpath)>(BOOST_PP_CAT(get_anchor_, __LINE__ )()); }, \
+    sizeof(std::declval<dsttype&>(). dstpath) \
+  })
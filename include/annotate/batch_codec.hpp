@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <type_traits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "./member_mapping.hpp"
+
+/*
+ * Batch compression
+ *
+ * Rationale : Frames of one device type are mostly identical across a fleet. A batch is seen as a table with one
+ *             column per byte of the frame. Each column is XORed against the frame of a default config, which
+ *             turns untouched settings into zeros, and split into its 8 bit planes, which turns a column of
+ *             small values or of single flags into whole zero planes. The planes are then coded as alternating
+ *             runs of zero bytes and literal bytes, lengths being LEB128 varints.
+ *
+ *             Format : 'A' 'B' varint(frame size) varint(count), then pairs varint(zeros) varint(literals)
+ *             followed by the literal bytes, until frame size * 8 planes * ceil(count / 8) bytes are produced.
+ *             Plane p of a column holds bit p of each row, LSB first.
+ */
+namespace batch_compression {
+
+  inline void put_varint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+      out.push_back(static_cast<uint8_t>(v) | 0x80);
+      v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+  }
+
+  inline bool get_varint(const uint8_t*& in, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (unsigned shift = 0; in != end && shift < 64; shift += 7) {
+      uint8_t byte = *in++;
+      v |= uint64_t(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+  }
+
+  /**
+   * Splits count bytes in 8 planes of stride bytes each.
+   */
+  inline void to_bit_planes(const uint8_t* column, size_t count, uint8_t* planes, size_t stride) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= count; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+      for (int p = 0; p < 8; ++p) {
+        // Moves bit p of each byte to its bit 7, where movemask picks it.
+        uint16_t bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_sll_epi16(v, _mm_cvtsi32_si128(7 - p))));
+        std::memcpy(planes + p * stride + i / 8, &bits, sizeof(bits));
+      }
+    }
+#endif
+    for (; i < count; ++i) {
+      if (i % 8 == 0) {
+        for (int p = 0; p < 8; ++p) { planes[p * stride + i / 8] = 0; }
+      }
+      for (int p = 0; p < 8; ++p) {
+        planes[p * stride + i / 8] |= static_cast<uint8_t>(((column[i] >> p) & 1) << (i % 8));
+      }
+    }
+  }
+
+  inline void from_bit_planes(const uint8_t* planes, size_t stride, size_t count, uint8_t* column) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i select = _mm_set1_epi64x(static_cast<long long>(0x8040201008040201ull));
+    for (; i + 16 <= count; i += 16) {
+      __m128i v = _mm_setzero_si128();
+      for (int p = 0; p < 8; ++p) {
+        const uint8_t* plane = planes + p * stride + i / 8;
+        // Spreads the 16 bits of the plane to 16 bytes, 0xFF where the bit is set.
+        __m128i spread = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(plane[0])),
+                                            _mm_set1_epi8(static_cast<char>(plane[1])));
+        __m128i set = _mm_cmpeq_epi8(_mm_and_si128(spread, select), select);
+        v = _mm_or_si128(v, _mm_and_si128(set, _mm_set1_epi8(static_cast<char>(1 << p))));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(column + i), v);
+    }
+#endif
+    for (; i < count; ++i) {
+      uint8_t byte = 0;
+      for (int p = 0; p < 8; ++p) {
+        byte |= static_cast<uint8_t>(((planes[p * stride + i / 8] >> (i % 8)) & 1) << p);
+      }
+      column[i] = byte;
+    }
+  }
+
+  inline void put_runs(std::vector<uint8_t>& out, const uint8_t* in, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+      size_t zeros = 0;
+      while (i + zeros < size && in[i + zeros] == 0) { ++zeros; }
+      i += zeros;
+
+      // A literal run stops at the first pair of zeros : a lone zero is cheaper kept as a literal.
+      size_t literals = 0;
+      while (i + literals < size &&
+             !(in[i + literals] == 0 && (i + literals + 1 == size || in[i + literals + 1] == 0))) {
+        ++literals;
+      }
+
+      put_varint(out, zeros);
+      put_varint(out, literals);
+      out.insert(out.end(), in + i, in + i + literals);
+      i += literals;
+    }
+  }
+
+  /**
+   * Bytes the runs from in to end produce, without producing them.
+   */
+  inline bool runs_size(const uint8_t* in, const uint8_t* end, uint64_t& size) {
+    size = 0;
+    while (in != end) {
+      uint64_t zeros, literals;
+      if (!get_varint(in, end, zeros) || !get_varint(in, end, literals)) { return false; }
+      if (literals > size_t(end - in) || zeros > ~uint64_t(0) - literals - size) { return false; }
+      size += zeros + literals;
+      in += literals;
+    }
+    return true;
+  }
+
+  inline bool get_runs(const uint8_t*& in, const uint8_t* end, uint8_t* out, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+      uint64_t zeros, literals;
+      if (!get_varint(in, end, zeros) || !get_varint(in, end, literals)) { return false; }
+      if (zeros > size - i || literals > size - i - zeros || literals > size_t(end - in)) { return false; }
+
+      std::memset(out + i, 0, zeros);
+      i += zeros;
+      std::memcpy(out + i, in, literals);
+      in += literals;
+      i += literals;
+    }
+    return true;
+  }
+}
+
+template <class Binary, class Config>
+struct batch_codec {
+
+  static_assert(std::is_trivially_copyable<Binary>::value, "frames are handled as bytes");
+
+  static constexpr size_t frame_size = sizeof(Binary);
+
+  /**
+   * The frame of a default constructed config, columns are XORed against it.
+   */
+  static const std::array<uint8_t, frame_size>& default_frame() {
+    static const std::array<uint8_t, frame_size> bytes = []() {
+      Binary frame{};
+      update_all(frame, Config{});
+      std::array<uint8_t, frame_size> b;
+      std::memcpy(b.data(), &frame, frame_size);
+      return b;
+    }();
+    return bytes;
+  }
+
+  static std::vector<uint8_t> compress(const Binary* frames, size_t count) {
+    using namespace batch_compression;
+
+    const size_t stride = (count + 7) / 8;
+    const uint8_t* rows = reinterpret_cast<const uint8_t*>(frames);
+    auto& defaults = default_frame();
+
+    std::vector<uint8_t> column(count);
+    std::vector<uint8_t> planes(frame_size * 8 * stride);
+    for (size_t c = 0; c < frame_size; ++c) {
+      for (size_t i = 0; i < count; ++i) {
+        column[i] = rows[i * frame_size + c] ^ defaults[c];
+      }
+      to_bit_planes(column.data(), count, planes.data() + c * 8 * stride, stride);
+    }
+
+    std::vector<uint8_t> out{'A', 'B'};
+    put_varint(out, frame_size);
+    put_varint(out, count);
+    put_runs(out, planes.data(), planes.size());
+    return out;
+  }
+
+  /**
+   * The whole batch is checked before anything is allocated for it : a count above max_frames, or which the
+   * runs that follow do not produce exactly, is refused.
+   * \return false if data is not a well formed batch of at most max_frames Binary frames.
+   */
+  static bool decompress(const uint8_t* data, size_t size, std::vector<Binary>& frames, size_t max_frames) {
+    using namespace batch_compression;
+
+    const uint8_t* in = data;
+    const uint8_t* end = data + size;
+    uint64_t stored_frame_size, count;
+    if (size < 2 || in[0] != 'A' || in[1] != 'B') { return false; }
+    in += 2;
+    if (!get_varint(in, end, stored_frame_size) || stored_frame_size != frame_size) { return false; }
+    if (!get_varint(in, end, count) || count > max_frames || count > (uint64_t(1) << 40)) { return false; }
+
+    const size_t stride = (count + 7) / 8;
+    uint64_t produced;
+    if (!runs_size(in, end, produced) || produced != frame_size * 8 * stride) { return false; }
+
+    std::vector<uint8_t> planes(frame_size * 8 * stride);
+    if (!get_runs(in, end, planes.data(), planes.size()) || in != end) { return false; }
+
+    frames.resize(count);
+    uint8_t* rows = reinterpret_cast<uint8_t*>(frames.data());
+    auto& defaults = default_frame();
+
+    std::vector<uint8_t> column(count);
+    for (size_t c = 0; c < frame_size; ++c) {
+      from_bit_planes(planes.data() + c * 8 * stride, stride, count, column.data());
+      for (size_t i = 0; i < count; ++i) {
+        rows[i * frame_size + c] = column[i] ^ defaults[c];
+      }
+    }
+    return true;
+  }
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Bulk conversion
+ *
+ * Rationale : A fleet is converted by splitting the input span in chunks small enough to stay in cache while
+ *             being converted. Each worker owns a range of chunk indices, takes chunks from its end and, once
+ *             empty, steals the first half of the range of another worker, so slow workers get unloaded
+ *             without a central queue. A chunk always writes the same disjoint slice of the output, so the
+ *             result does not depend on which worker ran it : it is byte for byte the single threaded one.
+ */
+class work_stealing_pool {
+public:
+
+  /**
+   * \param workers counts the calling thread, 0 is taken as 1 : the caller runs every task.
+   */
+  explicit work_stealing_pool(size_t workers = std::max(1u, std::thread::hardware_concurrency()))
+    : ranges_(std::max<size_t>(1, workers)) {
+    for (size_t w = 1; w < ranges_.size(); ++w) {
+      threads_.emplace_back([this, w]() { worker_loop(w); });
+    }
+  }
+
+  work_stealing_pool(const work_stealing_pool&) = delete;
+  work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+  ~work_stealing_pool() {
+    { std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : threads_) { t.join(); }
+  }
+
+  size_t size() const { return ranges_.size(); }
+
+  /**
+   * Runs task(i) for each i in [0, count) on all workers, the calling thread being worker 0.
+   * Returns once every task ran.
+   */
+  void parallel_for(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) { return; }
+
+    const size_t workers = ranges_.size();
+    for (size_t w = 0; w < workers; ++w) {
+      std::lock_guard<std::mutex> lock(ranges_[w].mutex);
+      ranges_[w].begin = count * w / workers;
+      ranges_[w].end = count * (w + 1) / workers;
+    }
+
+    { std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      remaining_ = count;
+      active_ = workers - 1;
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    run(0, task);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return remaining_ == 0 && active_ == 0; });
+    task_ = nullptr;
+  }
+
+private:
+
+  struct alignas(64) range {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+  };
+
+  void worker_loop(size_t w) {
+    size_t seen = 0;
+    for (;;) {
+      const std::function<void(size_t)>* task;
+      { std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+        if (stopping_) { return; }
+        seen = generation_;
+        task = task_;
+      }
+
+      run(w, *task);
+
+      { std::lock_guard<std::mutex> lock(mutex_);
+        --active_;
+      }
+      done_.notify_all();
+    }
+  }
+
+  void run(size_t w, const std::function<void(size_t)>& task) {
+    size_t ran = 0;
+    size_t index;
+    while (pop(w, index) || steal(w, index)) {
+      task(index);
+      ++ran;
+    }
+
+    if (ran > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      remaining_ -= ran;
+    }
+  }
+
+  bool pop(size_t w, size_t& index) {
+    std::lock_guard<std::mutex> lock(ranges_[w].mutex);
+    if (ranges_[w].begin == ranges_[w].end) { return false; }
+    index = --ranges_[w].end;
+    return true;
+  }
+
+  bool steal(size_t thief, size_t& index) {
+    const size_t workers = ranges_.size();
+    for (size_t k = 1; k < workers; ++k) {
+      range& victim = ranges_[(thief + k) % workers];
+      size_t begin, end;
+      { std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t available = victim.end - victim.begin;
+        if (available == 0) { continue; }
+        begin = victim.begin;
+        end = begin + (available + 1) / 2;
+        victim.begin = end;
+      }
+
+      std::lock_guard<std::mutex> lock(ranges_[thief].mutex);
+      ranges_[thief].begin = begin + 1;
+      ranges_[thief].end = end;
+      index = begin;
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<range> ranges_;
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* task_ = nullptr;
+  size_t generation_ = 0;
+  size_t remaining_ = 0;
+  size_t active_ = 0;
+  bool stopping_ = false;
+};
+
+/**
+ * Number of items per chunk so that the inputs and outputs of one chunk fit in CacheBytes.
+ */
+template <class SRC, class DEST, size_t CacheBytes = 32 * 1024>
+constexpr size_t chunk_items() {
+  return std::max<size_t>(1, CacheBytes / (sizeof(SRC) + sizeof(DEST)));
+}
+
+template <class Binary, class Config>
+inline void bulk_encode(work_stealing_pool& pool, const Config* configs, size_t count, Binary* frames) {
+  constexpr size_t chunk = chunk_items<Config, Binary>();
+  pool.parallel_for((count + chunk - 1) / chunk, [&](size_t c) {
+    const size_t end = std::min(count, (c + 1) * chunk);
+    for (size_t i = c * chunk; i < end; ++i) {
+      frames[i] = Binary{};
+      update_all(frames[i], configs[i]);
+    }
+  });
+}
+
+template <class Binary, class Config>
+inline void bulk_decode(work_stealing_pool& pool, const Binary* frames, size_t count, Config* configs) {
+  constexpr size_t chunk = chunk_items<Binary, Config>();
+  pool.parallel_for((count + chunk - 1) / chunk, [&](size_t c) {
+    const size_t end = std::min(count, (c + 1) * chunk);
+    for (size_t i = c * chunk; i < end; ++i) {
+      fill_all(frames[i], configs[i]);
+    }
+  });
+}
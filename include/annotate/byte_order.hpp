@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <type_traits>
+#include <boost/endian/buffers.hpp>
+
+#include "./wire_cast.hpp"
+#include "./member_mapping.hpp"
+
+/*
+ * Byte order
+ *
+ * Rationale : Wire formats written with boost::endian buffers convert each field on its own, a swap per multi
+ *             bytes field and a byte loop even for single bytes. Whether the bytes of a buffer are the bytes
+ *             of its model field is known at compile time : a single byte buffer, or a buffer in the host
+ *             order, holds them as they are ; a buffer in the other order holds them swapped.
+ *
+ *             byte_mapping tells it to the copy plan of member_mapping : such fields are not converted one by
+ *             one but copied in runs, plain memcpy for the former, swap_copy for the latter, which swaps 16
+ *             bytes per pshufb. copy_plan<Binary, Config>::layout classifies the whole frame : native frames
+ *             are copied as blobs, swapped ones only need swaps, mixed ones still have fields needing their
+ *             fill and update.
+ */
+
+template <boost::endian::order Order, class T, size_t Bits, boost::endian::align A, class M>
+struct byte_mapping<boost::endian::endian_buffer<Order, T, Bits, A>, M> {
+  static constexpr bool same_bits = std::is_integral<T>::value && std::is_integral<M>::value &&
+    !std::is_same<M, bool>::value && sizeof(T) * 8 == Bits && sizeof(M) == sizeof(T) && plain_casts<T, M>;
+  static constexpr bool in_order = Bits == 8 || Order == boost::endian::order::native;
+
+  static constexpr copy_kind kind =
+    !same_bits ? copy_kind::transform : (in_order ? copy_kind::identity : copy_kind::swap);
+  static constexpr size_t element = Bits / 8;
+};
+
+/**
+ * endian buffers on the wire convert through their value.
+ */
+template <class To, boost::endian::order Order, class T, size_t Bits, boost::endian::align A>
+struct wire_caster<To, boost::endian::endian_buffer<Order, T, Bits, A>> {
+  static To cast(const boost::endian::endian_buffer<Order, T, Bits, A>& v) { return wire_cast<To>(v.value()); }
+};
+
+template <boost::endian::order Order, class T, size_t Bits, boost::endian::align A, class From>
+struct wire_caster<boost::endian::endian_buffer<Order, T, Bits, A>, From> {
+  static boost::endian::endian_buffer<Order, T, Bits, A> cast(const From& v) {
+    return boost::endian::endian_buffer<Order, T, Bits, A>(wire_cast<T>(v));
+  }
+};
+
+template <class Rep, class Period, boost::endian::order Order, class T, size_t Bits, boost::endian::align A>
+struct wire_caster<std::chrono::duration<Rep, Period>, boost::endian::endian_buffer<Order, T, Bits, A>> {
+  static std::chrono::duration<Rep, Period> cast(const boost::endian::endian_buffer<Order, T, Bits, A>& v) {
+    return std::chrono::duration<Rep, Period>(v.value());
+  }
+};
+
+template <boost::endian::order Order, class T, size_t Bits, boost::endian::align A, class Rep, class Period>
+struct wire_caster<boost::endian::endian_buffer<Order, T, Bits, A>, std::chrono::duration<Rep, Period>> {
+  static boost::endian::endian_buffer<Order, T, Bits, A> cast(const std::chrono::duration<Rep, Period>& v) {
+    return boost::endian::endian_buffer<Order, T, Bits, A>(static_cast<T>(v.count()));
+  }
+};
+
+template <boost::endian::order Order, class T, size_t Bits, boost::endian::align A,
+          boost::endian::order FromOrder, class FromT, size_t FromBits, boost::endian::align FromA>
+struct wire_caster<boost::endian::endian_buffer<Order, T, Bits, A>,
+                   boost::endian::endian_buffer<FromOrder, FromT, FromBits, FromA>> {
+  static boost::endian::endian_buffer<Order, T, Bits, A>
+  cast(const boost::endian::endian_buffer<FromOrder, FromT, FromBits, FromA>& v) {
+    return boost::endian::endian_buffer<Order, T, Bits, A>(static_cast<T>(v.value()));
+  }
+};
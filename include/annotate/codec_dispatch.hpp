@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <boost/preprocessor/cat.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "./member_mapping.hpp"
+
+/*
+ * Codec kernels with runtime CPU dispatch
+ *
+ * Rationale : One binary has to run at its best on an old Atom as well as on a recent Xeon. Every kernel is
+ *             written once as a template on an instruction set trait, and instantiated in one entry point per
+ *             instruction set, compiled with the matching target attribute and flattened so that the generic
+ *             body gets vectorized for that instruction set. The CPU is probed once, and every mapped struct
+ *             binds its kernel table on first use. What is known at compile time, like the lane count of the
+ *             instruction set, is selected with if constexpr rather than util/static_if.hpp : the library
+ *             already requires C++17 (cxx_std_17), and a discarded if constexpr branch is never instantiated,
+ *             so the scalar trait needs no pack or unpack at all. Off x86 only the scalar kernels exist.
+ */
+enum class isa { scalar, sse42, avx2, avx512 };
+
+inline const char* isa_name(isa i) {
+  switch (i) {
+    case isa::sse42:  return "sse4.2";
+    case isa::avx2:   return "avx2";
+    case isa::avx512: return "avx512";
+    default:          return "scalar";
+  }
+}
+
+/**
+ * Best instruction set of this CPU, probed once. ANNOTATE_ISA=scalar|sse4.2|avx2|avx512 caps it.
+ */
+inline isa detected_isa() {
+  static const isa detected = []() {
+    isa best = isa::scalar;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) { best = isa::sse42; }
+    if (__builtin_cpu_supports("avx2")) { best = isa::avx2; }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) { best = isa::avx512; }
+#endif
+
+    if (const char* cap = std::getenv("ANNOTATE_ISA")) {
+      for (isa i : {isa::scalar, isa::sse42, isa::avx2, isa::avx512}) {
+        if (std::string(cap) == isa_name(i) && i < best) { best = i; }
+      }
+    }
+    return best;
+  }();
+  return detected;
+}
+
+struct isa_scalar {
+  static constexpr size_t lanes = 0;
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+struct isa_sse42 {
+  static constexpr size_t lanes = 16;
+
+  __attribute__((target("sse4.2"))) static uint64_t pack(const bool* in) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    return static_cast<uint16_t>(_mm_movemask_epi8(_mm_slli_epi16(v, 7)));
+  }
+
+  __attribute__((target("sse4.2"))) static void unpack(uint64_t bits, bool* out) {
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    const __m128i select = _mm_set1_epi64x(static_cast<long long>(0x8040201008040201ull));
+    __m128i v = _mm_shuffle_epi8(_mm_cvtsi32_si128(static_cast<int>(bits)), spread);
+    v = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(v, select), select), _mm_set1_epi8(1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+  }
+};
+
+struct isa_avx2 {
+  static constexpr size_t lanes = 32;
+
+  __attribute__((target("avx2"))) static uint64_t pack(const bool* in) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(v, 7)));
+  }
+
+  __attribute__((target("avx2"))) static void unpack(uint64_t bits, bool* out) {
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ull));
+    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)), spread);
+    v = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, select), select), _mm256_set1_epi8(1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+  }
+};
+
+struct isa_avx512 {
+  static constexpr size_t lanes = 64;
+
+  __attribute__((target("avx512f,avx512bw"))) static uint64_t pack(const bool* in) {
+    __m512i v = _mm512_loadu_si512(in);
+    return _mm512_test_epi8_mask(v, _mm512_set1_epi8(1));
+  }
+
+  __attribute__((target("avx512f,avx512bw"))) static void unpack(uint64_t bits, bool* out) {
+    _mm512_storeu_si512(out, _mm512_maskz_mov_epi8(bits, _mm512_set1_epi8(1)));
+  }
+};
+#endif
+
+/**
+ * Bit packing of bool columns, LSB first : bit i%8 of bits[i/8] is in[i].
+ */
+template <class Isa>
+inline void pack_bits_kernel(const bool* in, size_t count, uint8_t* bits) {
+  size_t i = 0;
+
+  if constexpr (Isa::lanes > 0) {
+    for (; i + Isa::lanes <= count; i += Isa::lanes) {
+      uint64_t packed = Isa::pack(in + i);
+      std::memcpy(bits + i / 8, &packed, Isa::lanes / 8);
+    }
+  }
+
+  for (; i < count; ++i) {
+    if (i % 8 == 0) { bits[i / 8] = 0; }
+    bits[i / 8] |= static_cast<uint8_t>(in[i] << (i % 8));
+  }
+}
+
+template <class Isa>
+inline void unpack_bits_kernel(const uint8_t* bits, size_t count, bool* out) {
+  size_t i = 0;
+
+  if constexpr (Isa::lanes > 0) {
+    for (; i + Isa::lanes <= count; i += Isa::lanes) {
+      uint64_t packed = 0;
+      std::memcpy(&packed, bits + i / 8, Isa::lanes / 8);
+      Isa::unpack(packed, out + i);
+    }
+  }
+
+  for (; i < count; ++i) {
+    out[i] = (bits[i / 8] >> (i % 8)) & 1;
+  }
+}
+
+template <class Binary, class Config>
+inline void encode_n_kernel(const Config* configs, size_t count, Binary* frames) {
+  for (size_t i = 0; i < count; ++i) {
+    frames[i] = Binary{};
+    update_all(frames[i], configs[i]);
+  }
+}
+
+template <class Binary, class Config>
+inline void decode_n_kernel(const Binary* frames, size_t count, Config* configs) {
+  for (size_t i = 0; i < count; ++i) {
+    fill_all(frames[i], configs[i]);
+  }
+}
+
+/**
+ * The instruction set entry points : same generic kernels, one target each.
+ */
+#define CODEC_KERNEL_ENTRY_POINTS(ISA_TRAIT, TARGET)                                                           \
+  template <class Binary, class Config>                                                                        \
+  struct BOOST_PP_CAT(ISA_TRAIT, _kernels) {                                                                   \
+    TARGET __attribute__((flatten)) static void encode_n(const Config* c, size_t n, Binary* f) {               \
+      encode_n_kernel(c, n, f);                                                                                \
+    }                                                                                                          \
+    TARGET __attribute__((flatten)) static void decode_n(const Binary* f, size_t n, Config* c) {               \
+      decode_n_kernel(f, n, c);                                                                                \
+    }                                                                                                          \
+    TARGET __attribute__((flatten)) static void pack_bits(const bool* in, size_t n, uint8_t* bits) {           \
+      pack_bits_kernel<ISA_TRAIT>(in, n, bits);                                                                \
+    }                                                                                                          \
+    TARGET __attribute__((flatten)) static void unpack_bits(const uint8_t* bits, size_t n, bool* out) {        \
+      unpack_bits_kernel<ISA_TRAIT>(bits, n, out);                                                             \
+    }                                                                                                          \
+  };
+
+CODEC_KERNEL_ENTRY_POINTS(isa_scalar, )
+#if defined(__x86_64__) || defined(__i386__)
+CODEC_KERNEL_ENTRY_POINTS(isa_sse42, __attribute__((target("sse4.2"))))
+CODEC_KERNEL_ENTRY_POINTS(isa_avx2, __attribute__((target("avx2"))))
+CODEC_KERNEL_ENTRY_POINTS(isa_avx512, __attribute__((target("avx512f,avx512bw"))))
+#endif
+
+template <class Binary, class Config>
+struct codec_kernels {
+  void (*encode_n)(const Config* configs, size_t count, Binary* frames);
+  void (*decode_n)(const Binary* frames, size_t count, Config* configs);
+  void (*pack_bits)(const bool* in, size_t count, uint8_t* bits);
+  void (*unpack_bits)(const uint8_t* bits, size_t count, bool* out);
+  isa bound;
+
+  template <template <class, class> class Entry>
+  static constexpr codec_kernels make(isa i) {
+    return { &Entry<Binary, Config>::encode_n, &Entry<Binary, Config>::decode_n,
+             &Entry<Binary, Config>::pack_bits, &Entry<Binary, Config>::unpack_bits, i };
+  }
+
+  static codec_kernels for_isa(isa i) {
+    switch (i) {
+#if defined(__x86_64__) || defined(__i386__)
+      case isa::avx512: return make<isa_avx512_kernels>(i);
+      case isa::avx2:   return make<isa_avx2_kernels>(i);
+      case isa::sse42:  return make<isa_sse42_kernels>(i);
+#endif
+      default:          return make<isa_scalar_kernels>(isa::scalar);
+    }
+  }
+};
+
+/**
+ * Kernels of a mapped struct, bound to the best instruction set on first use.
+ */
+template <class Binary, class Config>
+inline const codec_kernels<Binary, Config>& codec() {
+  static const codec_kernels<Binary, Config> bound = codec_kernels<Binary, Config>::for_isa(detected_isa());
+  return bound;
+}
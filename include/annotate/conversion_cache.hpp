@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+#include "./member_mapping.hpp"
+
+/*
+ * Conversion cache
+ *
+ * Rationale : Many modules of a building share the very same config. The cache key of a config is made of the
+ *             values of its mapped fields only, copied one after the other : unmapped members and padding never
+ *             make two identical configs miss. The key is hashed with the SSE4.2 crc32 instruction when the CPU
+ *             has it, 8 bytes at a time. The cache is set associative, each set of Ways entries being replaced
+ *             with the CLOCK algorithm, so its memory is bounded by its capacity.
+ *             A cache is meant to be used by one thread.
+ */
+template <class SRC, class DEST>
+struct mapped_key {
+
+  template <size_t... I>
+  static constexpr size_t size_of(std::index_sequence<I...>) {
+    return (size_t{0} + ... +
+      sizeof(decltype(member_mapping<SRC, DEST>::dest_value(std::integral_constant<size_t, I>{}, std::declval<const DEST&>()))));
+  }
+
+  static constexpr size_t size = size_of(typename member_mapping<SRC, DEST>::mappings{});
+
+  using type = std::array<uint8_t, size>;
+
+  template <size_t... I>
+  static void gather(const DEST& d, type& key, std::index_sequence<I...>) {
+    uint8_t* out = key.data();
+    auto put = [&out](const auto& value) {
+      std::memcpy(out, &value, sizeof(value));
+      out += sizeof(value);
+    };
+    (put(member_mapping<SRC, DEST>::dest_value(std::integral_constant<size_t, I>{}, d)), ...);
+  }
+
+  static type of(const DEST& d) {
+    type key;
+    gather(d, key, typename member_mapping<SRC, DEST>::mappings{});
+    return key;
+  }
+};
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) inline uint32_t crc32c_hash(const uint8_t* data, size_t size) {
+  uint64_t crc = ~uint32_t{0};
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    crc = _mm_crc32_u64(crc, word);
+  }
+  for (; i < size; ++i) {
+    crc = _mm_crc32_u8(static_cast<uint32_t>(crc), data[i]);
+  }
+  return ~static_cast<uint32_t>(crc);
+}
+#endif
+
+inline uint32_t fnv1a_hash(const uint8_t* data, size_t size) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < size; ++i) { h = (h ^ data[i]) * 16777619u; }
+  return h;
+}
+
+inline uint32_t key_hash(const uint8_t* data, size_t size) {
+#if defined(__x86_64__)
+  static const bool has_crc32 = __builtin_cpu_supports("sse4.2");
+  if (has_crc32) { return crc32c_hash(data, size); }
+#endif
+  return fnv1a_hash(data, size);
+}
+
+template <class Binary, class Config, size_t Ways = 8>
+class conversion_cache {
+public:
+
+  /**
+   * \param capacity is rounded up to a power of two sets of Ways entries.
+   */
+  explicit conversion_cache(size_t capacity) {
+    size_t sets = 1;
+    while (sets * Ways < capacity) { sets <<= 1; }
+    set_mask_ = sets - 1;
+    sets_.resize(sets);
+  }
+
+  /**
+   * \return the frame of config, encoded now or on a previous call with an identical config.
+   */
+  const Binary& encode(const Config& config) {
+    const key_type key = mapped_key<Binary, Config>::of(config);
+    const uint32_t hash = key_hash(key.data(), key.size());
+    set& s = sets_[hash & set_mask_];
+
+    for (auto& e : s.entries) {
+      if (e.used && e.hash == hash && e.key == key) {
+        e.referenced = true;
+        ++hits_;
+        return e.frame;
+      }
+    }
+
+    ++misses_;
+    entry& victim = s.evict();
+    if (victim.used) { ++evictions_; }
+
+    victim.used = true;
+    victim.referenced = true;
+    victim.hash = hash;
+    victim.key = key;
+    victim.frame = Binary{};
+    update_all(victim.frame, config);
+    return victim.frame;
+  }
+
+  size_t capacity() const { return sets_.size() * Ways; }
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+  size_t evictions() const { return evictions_; }
+
+private:
+
+  using key_type = typename mapped_key<Binary, Config>::type;
+
+  struct entry {
+    bool used = false;
+    bool referenced = false;
+    uint32_t hash = 0;
+    key_type key;
+    Binary frame;
+  };
+
+  struct set {
+    std::array<entry, Ways> entries;
+    size_t hand = 0;
+
+    /**
+     * CLOCK : the hand skips and clears the recently referenced entries.
+     */
+    entry& evict() {
+      for (;;) {
+        entry& e = entries[hand];
+        hand = (hand + 1) % Ways;
+        if (!e.used || !e.referenced) { return e; }
+        e.referenced = false;
+      }
+    }
+  };
+
+  std::vector<set> sets_;
+  size_t set_mask_;
+
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+  size_t evictions_ = 0;
+};
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <string>
+#include <charconv>
+#include <chrono>
+#include <utility>
+#include <system_error>
+#include <type_traits>
+
+#include <emmintrin.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "./member_mapping.hpp"
+
+/*
+ * CSV import
+ *
+ * Rationale : Commissioning exports have one row per module and one column per model field, named like the
+ *             destination path of its member_map (e.g. triac_01.polarity). The header is resolved once into a
+ *             parser per column, generated from the dest_field of each mapping. The rows are then read straight
+ *             from the mapped file : cells are found with an SSE2 delimiter scan and parsed in place with
+ *             std::from_chars, no cell is ever copied into a string.
+ *
+ *             Cells are unquoted. Booleans are 0, 1, false or true, durations are counted in the unit of the
+ *             model field. A row with a cell which does not parse is skipped and counted as rejected.
+ */
+namespace csv {
+
+  /**
+   * Read-only mapping of a whole file.
+   */
+  class mapped_file {
+  public:
+    explicit mapped_file(const std::string& path) {
+      int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) { throw std::system_error(errno, std::generic_category(), "open " + path); }
+
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "fstat " + path);
+      }
+
+      size_ = static_cast<size_t>(st.st_size);
+      if (size_ > 0) {
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+          int err = errno;
+          ::close(fd);
+          throw std::system_error(err, std::generic_category(), "mmap " + path);
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+      }
+      ::close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+      if (data_) { ::munmap(const_cast<char*>(data_), size_); }
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+  private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+  };
+
+  /**
+   * \return the first ',', '\n' or '\r' in [p, end), or end.
+   */
+  inline const char* find_delimiter(const char* p, const char* end) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    for (; p + 16 <= end; p += 16) {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+      const int mask = _mm_movemask_epi8(hits);
+      if (mask) { return p + __builtin_ctz(mask); }
+    }
+
+    for (; p < end; ++p) {
+      if (*p == ',' || *p == '\n' || *p == '\r') { return p; }
+    }
+    return end;
+  }
+
+  /**
+   * \return the number of '\n' in [p, end).
+   */
+  inline size_t count_lines(const char* p, const char* end) {
+    const __m128i lf = _mm_set1_epi8('\n');
+    size_t lines = 0;
+
+    for (; p + 16 <= end; p += 16) {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      lines += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, lf)));
+    }
+
+    for (; p < end; ++p) { lines += (*p == '\n'); }
+    return lines;
+  }
+
+  template <class T>
+  struct cell_parser {
+    static bool parse(const char* begin, const char* end, T& value) {
+      auto result = std::from_chars(begin, end, value);
+      return result.ec == std::errc{} && result.ptr == end;
+    }
+  };
+
+  template <>
+  struct cell_parser<bool> {
+    static bool parse(const char* begin, const char* end, bool& value) {
+      const size_t length = static_cast<size_t>(end - begin);
+      if (length == 1 && (*begin == '0' || *begin == '1')) { value = (*begin == '1'); return true; }
+      if (length == 4 && std::memcmp(begin, "true", 4) == 0) { value = true; return true; }
+      if (length == 5 && std::memcmp(begin, "false", 5) == 0) { value = false; return true; }
+      return false;
+    }
+  };
+
+  template <class Rep, class Period>
+  struct cell_parser<std::chrono::duration<Rep, Period>> {
+    static bool parse(const char* begin, const char* end, std::chrono::duration<Rep, Period>& value) {
+      Rep count{};
+      if (!cell_parser<Rep>::parse(begin, end, count)) { return false; }
+      value = std::chrono::duration<Rep, Period>(count);
+      return true;
+    }
+  };
+
+  /**
+   * Rows are counted from 1 without the header, first_rejected_row is 0 when no row was rejected.
+   */
+  struct import_result {
+    size_t rows = 0;
+    size_t rejected_rows = 0;
+    size_t first_rejected_row = 0;
+    std::vector<std::string> ignored_columns;
+  };
+
+  template <class Binary, class Config>
+  class importer {
+  public:
+
+    using mapping = member_mapping<Binary, Config>;
+    using mappings = typename mapping::mappings;
+
+    /**
+     * Appends a Config per row of the CSV in [data, data + size) to configs.
+     */
+    static import_result import(const char* data, size_t size, std::vector<Config>& configs) {
+      import_result result;
+      const char* p = data;
+      const char* const end = data + size;
+
+      std::vector<parse_fn> columns;
+      p = read_header(p, end, columns, result.ignored_columns);
+
+      configs.reserve(configs.size() + count_lines(p, end) + 1);
+
+      while (p < end) {
+        p = skip_line_breaks(p, end);
+        if (p == end) { break; }
+
+        Config config;
+        bool valid = true;
+        size_t column = 0;
+
+        for (;;) {
+          const char* cell_end = find_delimiter(p, end);
+          if (column < columns.size() && columns[column]) {
+            valid = columns[column](p, cell_end, config) && valid;
+          }
+          ++column;
+          p = cell_end;
+          if (p == end || *p != ',') { break; }
+          ++p;
+        }
+
+        ++result.rows;
+        if (valid) {
+          configs.push_back(config);
+        } else {
+          if (result.rejected_rows++ == 0) { result.first_rejected_row = result.rows; }
+        }
+      }
+
+      return result;
+    }
+
+    static import_result import(const std::string& path, std::vector<Config>& configs) {
+      mapped_file file(path);
+      return import(file.data(), file.size(), configs);
+    }
+
+  private:
+
+    using parse_fn = bool (*)(const char*, const char*, Config&);
+
+    template <size_t I>
+    static bool parse_field(const char* begin, const char* end, Config& config) {
+      auto& field = mapping::dest_field(std::integral_constant<size_t, I>{}, config);
+      return cell_parser<std::decay_t<decltype(field)>>::parse(begin, end, field);
+    }
+
+    template <size_t... I>
+    static parse_fn find_field(const char* begin, const char* end, std::index_sequence<I...>) {
+      static constexpr const char* names[] = { mapping::dest_name(std::integral_constant<size_t, I>{})... };
+      static constexpr parse_fn parsers[] = { &parse_field<I>... };
+
+      const size_t length = static_cast<size_t>(end - begin);
+      for (size_t i = 0; i < sizeof...(I); ++i) {
+        if (std::strlen(names[i]) == length && std::memcmp(names[i], begin, length) == 0) { return parsers[i]; }
+      }
+      return nullptr;
+    }
+
+    static const char* read_header(const char* p, const char* end, std::vector<parse_fn>& columns,
+                                   std::vector<std::string>& ignored) {
+      for (;;) {
+        const char* name_end = find_delimiter(p, end);
+        parse_fn parser = find_field(p, name_end, mappings{});
+        if (!parser) { ignored.emplace_back(p, name_end); }
+        columns.push_back(parser);
+        p = name_end;
+        if (p == end || *p != ',') { break; }
+        ++p;
+      }
+      return skip_line_breaks(p, end);
+    }
+
+    static const char* skip_line_breaks(const char* p, const char* end) {
+      while (p < end && (*p == '\n' || *p == '\r')) { ++p; }
+      return p;
+    }
+  };
+
+}
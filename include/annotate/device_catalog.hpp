@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Device catalog
+ *
+ * Rationale : A bus carries a mix of module types, so the codec has to be picked per frame from the device id.
+ *             Instead of a virtual hierarchy or a string map, each registered id gets its encode/decode
+ *             function pointers baked in a constexpr table indexed by the id itself : one indexed load and one
+ *             indirect call per frame. Unregistered ids point to stubs, so no branch is needed before the call.
+ */
+using device_id = uint8_t;
+
+template <device_id Id>
+struct device_registration : public std::false_type {};
+
+#define register_device(ID, BINARY_TYPE, CONFIG_TYPE)                                                          \
+  template<>                                                                                                   \
+  struct device_registration<ID> : public std::true_type {                                                     \
+    static_assert(member_mapping<BINARY_TYPE, CONFIG_TYPE>::value, "register_device needs a map_to");          \
+    typedef BINARY_TYPE binary_type;                                                                           \
+    typedef CONFIG_TYPE config_type;                                                                           \
+  };
+
+struct device_codec {
+  size_t frame_size;
+  size_t (*encode)(const void* config, char* frame, size_t capacity);
+  bool (*decode)(const char* frame, size_t size, void* config);
+};
+
+template <device_id Id>
+struct registered_codec {
+  typedef typename device_registration<Id>::binary_type binary_type;
+  typedef typename device_registration<Id>::config_type config_type;
+
+  static size_t encode(const void* config, char* frame, size_t capacity) {
+    if (capacity < sizeof(binary_type)) { return 0; }
+    binary_type bin{};
+    update_all(bin, *static_cast<const config_type*>(config));
+    std::memcpy(frame, &bin, sizeof(bin));
+    return sizeof(bin);
+  }
+
+  static bool decode(const char* frame, size_t size, void* config) {
+    if (size < sizeof(binary_type)) { return false; }
+    binary_type bin;
+    std::memcpy(&bin, frame, sizeof(bin));
+    fill_all(bin, *static_cast<config_type*>(config));
+    return true;
+  }
+
+  static constexpr device_codec codec() { return {sizeof(binary_type), &encode, &decode}; }
+};
+
+struct unregistered_codec {
+  static size_t encode(const void*, char*, size_t) { return 0; }
+  static bool decode(const char*, size_t, void*) { return false; }
+  static constexpr device_codec codec() { return {0, &encode, &decode}; }
+};
+
+template <device_id Id>
+constexpr device_codec make_device_codec(std::true_type) { return registered_codec<Id>::codec(); }
+
+template <device_id Id>
+constexpr device_codec make_device_codec(std::false_type) { return unregistered_codec::codec(); }
+
+/**
+ * Dense jump table over the ids [0, MaxId]. Lookup must happen after every register_device of the program.
+ */
+template <device_id MaxId>
+struct device_catalog {
+
+  static constexpr size_t size = size_t{MaxId} + 1;
+
+  template <size_t... I>
+  static constexpr std::array<device_codec, size> make_table(std::index_sequence<I...>) {
+    return {{ make_device_codec<I>(device_registration<I>{})... }};
+  }
+
+  static constexpr std::array<device_codec, size> table = make_table(std::make_index_sequence<size>{});
+
+  static const device_codec& lookup(device_id id) {
+    return (id < size) ? table[id] : out_of_range;
+  }
+
+  static bool is_registered(device_id id) { return lookup(id).frame_size != 0; }
+
+  /**
+   * \return the number of bytes written to frame, 0 if the id is unknown or its frame exceeds capacity.
+   */
+  static size_t encode(device_id id, const void* config, char* frame, size_t capacity) {
+    return lookup(id).encode(config, frame, capacity);
+  }
+
+  static bool decode(device_id id, const char* frame, size_t size, void* config) {
+    return lookup(id).decode(frame, size, config);
+  }
+
+  static constexpr device_codec out_of_range = unregistered_codec::codec();
+};
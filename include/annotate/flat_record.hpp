@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Flat record
+ *
+ * Rationale : A flat record is generated from the mapped fields of a member_mapping : each model value gets a
+ *             fixed width type (bools are uint8_t, durations their count as int64_t) and they follow each other
+ *             without padding, in mapping order. The layout hash covers names and sizes, so that a reader
+ *             built against another layout refuses the record instead of misreading it. c_header() gives the
+ *             same layout as a packed C struct for readers written in other languages.
+ *
+ *             flat_type is the fixed width type of a model value, also used by live_state_table.hpp.
+ */
+template <class T>
+struct flat_type {
+  static_assert(std::is_integral<T>::value, "no flat representation for this model type");
+  using type = T;
+  static type to(const T& v) { return v; }
+  static T from(const type& v) { return v; }
+};
+
+template <>
+struct flat_type<bool> {
+  using type = uint8_t;
+  static type to(bool v) { return v ? 1 : 0; }
+  static bool from(type v) { return v != 0; }
+};
+
+template <class Rep, class Period>
+struct flat_type<std::chrono::duration<Rep, Period>> {
+  using type = int64_t;
+  static type to(const std::chrono::duration<Rep, Period>& v) { return static_cast<type>(v.count()); }
+  static std::chrono::duration<Rep, Period> from(type v) { return std::chrono::duration<Rep, Period>(static_cast<Rep>(v)); }
+};
+
+template <class T> constexpr const char* c_type_name();
+template <> constexpr const char* c_type_name<uint8_t>() { return "uint8_t"; }
+template <> constexpr const char* c_type_name<int8_t>() { return "int8_t"; }
+template <> constexpr const char* c_type_name<uint16_t>() { return "uint16_t"; }
+template <> constexpr const char* c_type_name<int16_t>() { return "int16_t"; }
+template <> constexpr const char* c_type_name<uint32_t>() { return "uint32_t"; }
+template <> constexpr const char* c_type_name<int32_t>() { return "int32_t"; }
+template <> constexpr const char* c_type_name<uint64_t>() { return "uint64_t"; }
+template <> constexpr const char* c_type_name<int64_t>() { return "int64_t"; }
+
+template <class Binary, class Config>
+struct flat_record_layout {
+
+  using mapping = member_mapping<Binary, Config>;
+
+  static constexpr size_t fields = typename mapping::mappings{}.size();
+
+  template <size_t I>
+  using anchor = std::integral_constant<size_t, I>;
+
+  template <size_t I>
+  using value_type = std::decay_t<decltype(mapping::dest_value(anchor<I>{}, std::declval<const Config&>()))>;
+
+  template <size_t I>
+  using flat = flat_type<value_type<I>>;
+
+  template <size_t... I>
+  static constexpr std::array<size_t, fields + 1> make_offsets(std::index_sequence<I...>) {
+    std::array<size_t, fields + 1> offsets{};
+    size_t sizes[] = { sizeof(typename flat<I>::type)... };
+    for (size_t i = 0; i < fields; ++i) { offsets[i + 1] = offsets[i] + sizes[i]; }
+    return offsets;
+  }
+
+  static constexpr std::array<size_t, fields + 1> offsets = make_offsets(typename mapping::mappings{});
+
+  static constexpr size_t size = offsets[fields];
+
+  template <size_t... I>
+  static constexpr uint32_t make_hash(std::index_sequence<I...>) {
+    uint32_t h = 2166136261u;
+    const char* names[] = { mapping::dest_name(anchor<I>{})... };
+    for (size_t i = 0; i < fields; ++i) {
+      for (const char* c = names[i]; *c != '\0'; ++c) { h = (h ^ static_cast<uint8_t>(*c)) * 16777619u; }
+      h = (h ^ static_cast<uint32_t>(offsets[i + 1] - offsets[i])) * 16777619u;
+    }
+    return h;
+  }
+
+  static constexpr uint32_t hash = make_hash(typename mapping::mappings{});
+};
+
+template <class Binary, class Config>
+struct flat_record {
+
+  using layout = flat_record_layout<Binary, Config>;
+
+  std::array<uint8_t, layout::size> bytes{};
+
+  template <size_t I>
+  typename layout::template flat<I>::type get() const {
+    typename layout::template flat<I>::type v;
+    std::memcpy(&v, bytes.data() + layout::offsets[I], sizeof(v));
+    return v;
+  }
+
+  template <size_t I>
+  void set(typename layout::template flat<I>::type v) {
+    std::memcpy(bytes.data() + layout::offsets[I], &v, sizeof(v));
+  }
+
+  static flat_record of(const Config& config) {
+    flat_record record;
+    record.store(config, typename layout::mapping::mappings{});
+    return record;
+  }
+
+  void to(Config& config) const {
+    load(config, typename layout::mapping::mappings{});
+  }
+
+private:
+  template <size_t... I>
+  void store(const Config& config, std::index_sequence<I...>) {
+    (set<I>(layout::template flat<I>::to(layout::mapping::dest_value(std::integral_constant<size_t, I>{}, config))), ...);
+  }
+
+  template <size_t... I>
+  void load(Config& config, std::index_sequence<I...>) const {
+    ((layout::mapping::dest_field(std::integral_constant<size_t, I>{}, config) = layout::template flat<I>::from(get<I>())), ...);
+  }
+};
+
+/**
+ * The flat record as a packed C struct, dots of the model paths become underscores.
+ */
+template <class Binary, class Config, size_t... I>
+std::string c_header(const std::string& name, std::index_sequence<I...>) {
+  using layout = flat_record_layout<Binary, Config>;
+
+  std::string header = "/* Generated flat record, layout 0x" + [] {
+      char hex[9];
+      std::snprintf(hex, sizeof(hex), "%08x", layout::hash);
+      return std::string(hex);
+    }() + " */\n#include <stdint.h>\n#pragma pack(push, 1)\nstruct " + name + " {\n";
+
+  auto field = [&](const char* type, std::string path) {
+    for (auto& c : path) { if (c == '.') { c = '_'; } }
+    header += "  " + std::string(type) + " " + path + ";\n";
+  };
+  (field(c_type_name<typename layout::template flat<I>::type>(),
+         layout::mapping::dest_name(std::integral_constant<size_t, I>{})), ...);
+
+  header += "};\n#pragma pack(pop)\n";
+  return header;
+}
+
+template <class Binary, class Config>
+std::string c_header(const std::string& name) {
+  return c_header<Binary, Config>(name, typename member_mapping<Binary, Config>::mappings{});
+}
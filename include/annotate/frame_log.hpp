@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <system_error>
+#include <type_traits>
+
+/*
+ * Frame log
+ *
+ * Rationale : Synthetic benchmarks do not have the traffic mix of a real link. A frame log captures it : each frame
+ *             as it came, the raw bytes the fwrite path writes, with the device it came from and a timestamp, so
+ *             that it can be replayed later, always the same, through the whole decoding pipeline (replay.hpp).
+ *
+ *             The log is a header, the magic "annotate", the format version and the frame size, followed by one
+ *             record per frame : 8 bytes of timestamp in nanoseconds, 4 of device, then the frame. Numbers are
+ *             in the order of the host which recorded them ; only differences of timestamps matter. A record cut
+ *             short by a capture which stopped in the middle of a write is left out when reading.
+ */
+struct frame_log_header {
+  char magic[8] = { 'a', 'n', 'n', 'o', 't', 'a', 't', 'e' };
+  uint32_t version = 1;
+  uint32_t frame_size = 0;
+};
+
+inline uint64_t frame_log_now() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+template <class Binary>
+class frame_log_writer {
+  static_assert(std::is_trivially_copyable<Binary>::value, "frames are logged as their bytes");
+
+public:
+
+  /**
+   * \throw std::system_error when path cannot be created.
+   */
+  explicit frame_log_writer(const std::string& path) : path_(path), file_(std::fopen(path.c_str(), "wb")) {
+    if (!file_) { throw std::system_error(errno, std::generic_category(), "fopen " + path); }
+    frame_log_header header;
+    header.frame_size = sizeof(Binary);
+    write(&header, sizeof(header));
+  }
+
+  frame_log_writer(const frame_log_writer&) = delete;
+  frame_log_writer& operator=(const frame_log_writer&) = delete;
+
+  ~frame_log_writer() {
+    if (file_) { std::fclose(file_); }
+  }
+
+  /**
+   * \throw std::system_error on a write failure.
+   */
+  void record(uint32_t device, const Binary& frame, uint64_t timestamp_ns = frame_log_now()) {
+    write(&timestamp_ns, sizeof(timestamp_ns));
+    write(&device, sizeof(device));
+    write(&frame, sizeof(Binary));
+    ++records_;
+  }
+
+  void flush() {
+    if (std::fflush(file_) != 0) { throw std::system_error(errno, std::generic_category(), "fflush " + path_); }
+  }
+
+  size_t records() const { return records_; }
+
+private:
+
+  void write(const void* data, size_t size) {
+    if (std::fwrite(data, size, 1, file_) != 1) {
+      throw std::system_error(errno, std::generic_category(), "fwrite " + path_);
+    }
+  }
+
+  std::string path_;
+  std::FILE* file_;
+  size_t records_ = 0;
+};
+
+/**
+ * A whole log, loaded in memory : a replay measures the decoding, not the disk.
+ */
+template <class Binary>
+class frame_log {
+  static_assert(std::is_trivially_copyable<Binary>::value, "frames are logged as their bytes");
+
+public:
+
+  struct record {
+    uint64_t timestamp;
+    uint32_t device;
+    Binary frame;
+  };
+
+  static constexpr size_t record_size = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(Binary);
+
+  /**
+   * \throw std::system_error when path cannot be read, EPROTO when it is not a log of Binary frames.
+   */
+  explicit frame_log(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) { throw std::system_error(errno, std::generic_category(), "fopen " + path); }
+
+    frame_log_header header;
+    const frame_log_header expected{};
+    const bool is_log = std::fread(&header, sizeof(header), 1, file) == 1 &&
+      std::memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 && header.version == expected.version;
+    if (!is_log || header.frame_size != sizeof(Binary)) {
+      std::fclose(file);
+      throw std::system_error(EPROTO, std::generic_category(),
+                              path + (is_log ? " holds frames of another size" : " is not a frame log"));
+    }
+
+    unsigned char bytes[record_size];
+    while (std::fread(bytes, record_size, 1, file) == 1) {
+      record r;
+      std::memcpy(&r.timestamp, bytes, sizeof(uint64_t));
+      std::memcpy(&r.device, bytes + sizeof(uint64_t), sizeof(uint32_t));
+      std::memcpy(&r.frame, bytes + sizeof(uint64_t) + sizeof(uint32_t), sizeof(Binary));
+      records_.push_back(r);
+    }
+    const bool failed = std::ferror(file);
+    std::fclose(file);
+    if (failed) { throw std::system_error(EIO, std::generic_category(), "fread " + path); }
+  }
+
+  const std::vector<record>& records() const { return records_; }
+  size_t size() const { return records_.size(); }
+
+private:
+  std::vector<record> records_;
+};
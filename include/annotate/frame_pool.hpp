@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Frame buffer pool
+ *
+ * Rationale : Every frame used to go through a malloc/free pair. frame_pool<Frame> is an arena of fixed size
+ *             slots, sizeof(Frame) each, grown by chunks that are never given back to the heap. Each thread keeps
+ *             its own cache of free slots, which it uses without any synchronization. Only when a cache is
+ *             empty or full it exchanges slots with a shared lock-free stack. The stack links slots by index and
+ *             tags its head with a generation counter against ABA. A mutex is only taken to add a chunk.
+ */
+template <class Frame, size_t SlotsPerChunk = 1024>
+class frame_pool {
+public:
+
+  static_assert(std::is_trivially_copyable<Frame>::value, "frames are memcpy'd to and from the wire");
+  static_assert(std::is_trivially_destructible<Frame>::value, "frames are never destroyed, only recycled");
+
+  /**
+   * The only pool of Frame : the thread caches are per instantiation, so there can be no other.
+   */
+  static frame_pool& instance() {
+    static frame_pool pool;
+    return pool;
+  }
+
+  frame_pool(const frame_pool&) = delete;
+  frame_pool& operator=(const frame_pool&) = delete;
+
+  void* allocate() {
+    thread_cache& cache = local_cache();
+    if (cache.count == 0) { refill(cache); }
+    return cache.slots[--cache.count];
+  }
+
+  void deallocate(void* slot) {
+    thread_cache& cache = local_cache();
+    if (cache.count == thread_cache::capacity) { drain(cache, thread_cache::capacity / 2); }
+    cache.slots[cache.count++] = slot;
+  }
+
+  /**
+   * \return how many slots were ever carved from the arena, i.e. the high water mark of frames alive.
+   */
+  size_t reserved_slots() const { return std::min<size_t>(bump_.load(std::memory_order_relaxed), max_slots); }
+
+  ~frame_pool() {
+    for (auto& c : chunks_) { std::free(c.load(std::memory_order_relaxed)); }
+  }
+
+private:
+
+  static constexpr size_t slot_stride = (sizeof(Frame) + alignof(Frame) - 1) / alignof(Frame) * alignof(Frame);
+  static constexpr size_t max_chunks = 4096;
+  static constexpr size_t max_slots = max_chunks * SlotsPerChunk;
+
+  static constexpr size_t ceil_pow2(size_t v) {
+    size_t p = 1;
+    while (p < v) { p <<= 1; }
+    return p;
+  }
+
+  struct chunk {
+    uint32_t number;
+    std::atomic<uint32_t> next[SlotsPerChunk];
+    alignas(Frame) unsigned char slots[SlotsPerChunk * slot_stride];
+  };
+
+  // Chunks are aligned on their own power of two size, so the owning chunk of a slot is found by masking.
+  static constexpr size_t chunk_bytes = ceil_pow2(sizeof(chunk));
+
+  struct thread_cache {
+    static constexpr size_t capacity = 64;
+
+    explicit thread_cache(frame_pool* owner) : pool(owner) {}
+    ~thread_cache() { pool->drain(*this, count); }
+
+    frame_pool* pool;
+    size_t count = 0;
+    void* slots[capacity];
+  };
+
+  frame_pool() {
+    for (auto& c : chunks_) { c.store(nullptr, std::memory_order_relaxed); }
+  }
+
+  // One per thread and per instantiation, which is one per pool as instance() is the only way to a pool.
+  thread_cache& local_cache() {
+    static thread_local thread_cache cache{this};
+    return cache;
+  }
+
+  static chunk* chunk_of(void* slot) {
+    return reinterpret_cast<chunk*>(reinterpret_cast<uintptr_t>(slot) & ~uintptr_t(chunk_bytes - 1));
+  }
+
+  uint32_t index_of(void* slot) const {
+    chunk* c = chunk_of(slot);
+    return static_cast<uint32_t>(c->number * SlotsPerChunk +
+      (static_cast<unsigned char*>(slot) - c->slots) / slot_stride);
+  }
+
+  void* slot_at(uint32_t index) const {
+    chunk* c = chunks_[index / SlotsPerChunk].load(std::memory_order_acquire);
+    return c->slots + (index % SlotsPerChunk) * slot_stride;
+  }
+
+  std::atomic<uint32_t>& next_of(uint32_t index) const {
+    return chunks_[index / SlotsPerChunk].load(std::memory_order_acquire)->next[index % SlotsPerChunk];
+  }
+
+  /**
+   * The shared stack head packs the generation tag in the high word and index + 1 in the low word, 0 is empty.
+   */
+  void push_shared(void* slot) {
+    uint32_t index = index_of(slot);
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+      next_of(index).store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+      desired = (((head >> 32) + 1) << 32) | (index + 1);
+    } while (!free_head_.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  void* pop_shared() {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    uint64_t desired;
+    do {
+      uint32_t top = static_cast<uint32_t>(head);
+      if (top == 0) { return nullptr; }
+      uint32_t next = next_of(top - 1).load(std::memory_order_relaxed);
+      desired = (((head >> 32) + 1) << 32) | next;
+    } while (!free_head_.compare_exchange_weak(head, desired, std::memory_order_acquire, std::memory_order_acquire));
+
+    return slot_at(static_cast<uint32_t>(head) - 1);
+  }
+
+  void* carve() {
+    size_t index = bump_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= max_slots) { throw std::bad_alloc{}; }
+
+    size_t number = index / SlotsPerChunk;
+    if (chunks_[number].load(std::memory_order_acquire) == nullptr) {
+      std::lock_guard<std::mutex> lock(grow_mutex_);
+      if (chunks_[number].load(std::memory_order_relaxed) == nullptr) {
+        chunk* c = static_cast<chunk*>(std::aligned_alloc(chunk_bytes, chunk_bytes));
+        if (c == nullptr) { throw std::bad_alloc{}; }
+        c->number = static_cast<uint32_t>(number);
+        for (auto& n : c->next) { new (&n) std::atomic<uint32_t>(0); }
+        chunks_[number].store(c, std::memory_order_release);
+      }
+    }
+
+    return slot_at(static_cast<uint32_t>(index));
+  }
+
+  void refill(thread_cache& cache) {
+    while (cache.count < thread_cache::capacity / 2) {
+      void* slot = pop_shared();
+      if (slot == nullptr) { break; }
+      cache.slots[cache.count++] = slot;
+    }
+    if (cache.count == 0) { cache.slots[cache.count++] = carve(); }
+  }
+
+  void drain(thread_cache& cache, size_t n) {
+    for (; n > 0; --n) { push_shared(cache.slots[--cache.count]); }
+  }
+
+  std::atomic<uint64_t> free_head_{0};
+  std::atomic<size_t> bump_{0};
+  mutable std::atomic<chunk*> chunks_[max_chunks];
+  std::mutex grow_mutex_;
+};
+
+/**
+ * Owning handle on one pooled frame, the slot goes back to the pool of the releasing thread.
+ */
+template <class Frame>
+class frame_buffer {
+public:
+
+  frame_buffer() = default;
+
+  static frame_buffer acquire() {
+    return frame_buffer{ new (frame_pool<Frame>::instance().allocate()) Frame{} };
+  }
+
+  frame_buffer(frame_buffer&& other) noexcept : frame_(other.frame_) { other.frame_ = nullptr; }
+
+  frame_buffer& operator=(frame_buffer&& other) noexcept {
+    std::swap(frame_, other.frame_);
+    return *this;
+  }
+
+  frame_buffer(const frame_buffer&) = delete;
+  frame_buffer& operator=(const frame_buffer&) = delete;
+
+  ~frame_buffer() {
+    if (frame_ != nullptr) { frame_pool<Frame>::instance().deallocate(frame_); }
+  }
+
+  explicit operator bool() const { return frame_ != nullptr; }
+
+  Frame& frame() { return *frame_; }
+  const Frame& frame() const { return *frame_; }
+
+  char* data() { return reinterpret_cast<char*>(frame_); }
+  const char* data() const { return reinterpret_cast<const char*>(frame_); }
+  static constexpr size_t size() { return sizeof(Frame); }
+
+private:
+  explicit frame_buffer(Frame* frame) : frame_(frame) {}
+
+  Frame* frame_ = nullptr;
+};
+
+/**
+ * Encodes into a buffer coming from the pool, the frame is written in place.
+ */
+template <class Frame, class Config>
+inline frame_buffer<Frame>& encode(const Config& config, frame_buffer<Frame>& buffer) {
+  buffer.frame() = Frame{};
+  update_all(buffer.frame(), config);
+  return buffer;
+}
+
+template <class Frame, class Config>
+inline frame_buffer<Frame> encode(const Config& config) {
+  auto buffer = frame_buffer<Frame>::acquire();
+  update_all(buffer.frame(), config);
+  return buffer;
+}
+
+template <class Config, class Frame>
+inline Config decode(const frame_buffer<Frame>& buffer) {
+  Config config;
+  fill_all(buffer.frame(), config);
+  return config;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <bitset>
+#include <utility>
+
+#include <emmintrin.h>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Incremental decode
+ *
+ * Rationale : A status frame mostly repeats the previous one. The previous and the new frame are XORed 16 bytes
+ *             at a time with SSE2 (the tail 8 bytes at a time), and each flipped bit is looked up in a bit to field
+ *             table : only the fields whose bits changed are decoded, through a jump table of the fill of each
+ *             member_map.
+ *
+ *             The bit positions of bitfields are not constant expressions, so the table cannot be computed by
+ *             the compiler : it is built once per mapping, on first use, from the bits mark_source sets in a
+ *             frame of zeros, all the bits of each binary field whatever part of them its conversion keeps. A
+ *             bit may feed several fields, each bit has the set of its fields. Reserved bits belong to no field
+ *             and their changes are ignored.
+ */
+template <class Binary, class Config>
+class incremental_decoder {
+public:
+
+  using mapping = member_mapping<Binary, Config>;
+  using mappings = typename mapping::mappings;
+  static constexpr size_t fields = mappings::size();
+
+  using changes = std::bitset<fields>;
+
+  /**
+   * \return the fields whose bits differ between previous and next.
+   */
+  static changes diff(const Binary& previous, const Binary& next) {
+    return scan(previous, next);
+  }
+
+  /**
+   * Decodes into config, which holds the decoding of previous, only the fields which changed in next.
+   * \return the fields which changed.
+   */
+  static changes decode(const Binary& previous, const Binary& next, Config& config) {
+    const changes changed = scan(previous, next);
+    if constexpr (fields <= 64) {
+      for (uint64_t left = changed.to_ullong(); left; left &= left - 1) {
+        fill_table[__builtin_ctzll(left)](next, config);
+      }
+    } else {
+      for (size_t field = 0; field < fields; ++field) {
+        if (changed[field]) { fill_table[field](next, config); }
+      }
+    }
+    return changed;
+  }
+
+private:
+
+  static changes scan(const Binary& previous, const Binary& next) {
+    const auto* a = reinterpret_cast<const uint8_t*>(&previous);
+    const auto* b = reinterpret_cast<const uint8_t*>(&next);
+    const bit_owners& owners = table();
+    changes changed;
+
+    constexpr size_t vectors = sizeof(Binary) / 16 * 16;
+    constexpr size_t words = sizeof(Binary) / 8 * 8;
+    constexpr size_t rest = sizeof(Binary) - words;
+
+    for (size_t block = 0; block < vectors; block += 16) {
+      const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + block));
+      const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + block));
+      const __m128i flipped = _mm_xor_si128(x, y);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(flipped, _mm_setzero_si128())) == 0xFFFF) { continue; }
+      mark(owners, block, static_cast<uint64_t>(_mm_cvtsi128_si64(flipped)), changed);
+      const __m128i high = _mm_unpackhi_epi64(flipped, flipped);
+      mark(owners, block + 8, static_cast<uint64_t>(_mm_cvtsi128_si64(high)), changed);
+    }
+
+    // The tail, shorter than a vector, is compared 8 bytes at a time.
+    for (size_t block = vectors; block < words; block += 8) {
+      uint64_t x, y;
+      std::memcpy(&x, a + block, 8);
+      std::memcpy(&y, b + block, 8);
+      mark(owners, block, x ^ y, changed);
+    }
+
+    if (rest != 0) {
+      uint64_t x = 0, y = 0;
+      std::memcpy(&x, a + words, rest);
+      std::memcpy(&y, b + words, rest);
+      mark(owners, words, x ^ y, changed);
+    }
+
+    return changed;
+  }
+
+  /**
+   * The fields each bit of the frame feeds, none for reserved bits.
+   */
+  using bit_owners = std::array<changes, sizeof(Binary) * 8>;
+
+  static void mark(const bit_owners& owners, size_t byte, uint64_t flipped, changes& changed) {
+    while (flipped) {
+      changed |= owners[byte * 8 + __builtin_ctzll(flipped)];
+      flipped &= flipped - 1;
+    }
+  }
+
+  using fill_fn = void (*)(const Binary&, Config&);
+
+  template <size_t I>
+  static void fill_one(const Binary& frame, Config& config) {
+    mapping::fill(std::integral_constant<size_t, I>{}, frame, config);
+  }
+
+  template <size_t... I>
+  static constexpr std::array<fill_fn, fields> make_fill_table(std::index_sequence<I...>) {
+    return {{ &fill_one<I>... }};
+  }
+
+  static constexpr std::array<fill_fn, fields> fill_table = make_fill_table(mappings{});
+
+  template <size_t I>
+  static void own(bit_owners& owners) {
+    Binary source;
+    std::memset(&source, 0, sizeof(Binary));
+    mark_source_of<mapping, I>(source, 0);
+
+    const auto* bits = reinterpret_cast<const uint8_t*>(&source);
+    for (size_t bit = 0; bit < owners.size(); ++bit) {
+      if (bits[bit / 8] & (1u << (bit % 8))) { owners[bit].set(I); }
+    }
+  }
+
+  template <size_t... I>
+  static bit_owners make_table(std::index_sequence<I...>) {
+    bit_owners owners{};
+    (own<I>(owners), ...);
+    return owners;
+  }
+
+  static const bit_owners& table() {
+    static const bit_owners owners = make_table(mappings{});
+    return owners;
+  }
+};
+
+template <class Binary, class Config>
+constexpr std::array<typename incremental_decoder<Binary, Config>::fill_fn, incremental_decoder<Binary, Config>::fields>
+incremental_decoder<Binary, Config>::fill_table;
+
+/**
+ * Keeps the last frame and decoding of a device, applies the next frames incrementally.
+ */
+template <class Binary, class Config>
+class incremental_state {
+public:
+  using decoder = incremental_decoder<Binary, Config>;
+  using changes = typename decoder::changes;
+
+  explicit incremental_state(const Binary& first) : frame_(first) { fill_all(frame_, config_); }
+
+  changes apply(const Binary& next) {
+    const changes changed = decoder::decode(frame_, next, config_);
+    frame_ = next;
+    return changed;
+  }
+
+  const Config& config() const { return config_; }
+
+private:
+  Binary frame_;
+  Config config_;
+};
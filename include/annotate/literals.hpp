@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Widths and alignments of binary representations, so that they read like the device documentation :
+ * `bool triac_01 : 1_bits;` in a `struct alignas(1_byte)`.
+ */
+constexpr size_t operator "" _bits(unsigned long long val) { return val; }
+constexpr size_t operator "" _byte(unsigned long long val) { return val; }
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+#include "./flat_record.hpp"
+
+/*
+ * Live state table
+ *
+ * Rationale : Many threads poll the latest decoded state of the devices, one thread decodes. The table is
+ *             indexed directly by the bus address, so there is no lookup structure to protect. In an entry,
+ *             each mapped field is its own atomic of a fixed width type (bools as uint8_t, durations as their
+ *             int64_t count) : reading a field is one load, and reading a whole config is one pass over the
+ *             fields, whatever the writer does. Readers are wait-free.
+ *
+ *             The writer decodes a frame field by field with the member_map of each field, and only stores the
+ *             fields that changed. Around the stores it bumps the entry version, odd while writing, so that a
+ *             reader knows if its snapshot mixes two frames and can try again if it needs a consistent one.
+ */
+enum class snapshot { absent, consistent, mixed };
+
+template <class Binary, class Config, size_t Addresses = 256>
+class live_state_table {
+public:
+
+  using mapping = member_mapping<Binary, Config>;
+  using mappings = typename mapping::mappings;
+
+  /**
+   * Decodes frame into the entry of address. Single writer only.
+   * \return how many fields changed.
+   * \throw std::out_of_range for an address past the table, e.g. read off the wire.
+   */
+  size_t update(size_t address, const Binary& frame) {
+    if (address >= Addresses) { throw std::out_of_range("live_state_table address " + std::to_string(address)); }
+    entry& e = entries_[address];
+    const uint64_t version = e.version.load(std::memory_order_relaxed);
+    e.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const bool was_present = e.present.load(std::memory_order_relaxed);
+    const size_t changed = update_fields(e, frame, !was_present, mappings{});
+
+    e.present.store(true, std::memory_order_relaxed);
+    e.version.store(version + 2, std::memory_order_release);
+    return changed;
+  }
+
+  /**
+   * Wait-free : one pass over the fields of the entry.
+   * \return whether the entry was ever written, and if the writer updated it while it was read. Addresses past
+   *         the table are absent.
+   */
+  snapshot read(size_t address, Config& config) const {
+    if (address >= Addresses) { return snapshot::absent; }
+    const entry& e = entries_[address];
+    const uint64_t before = e.version.load(std::memory_order_acquire);
+    if (!e.present.load(std::memory_order_relaxed)) { return snapshot::absent; }
+
+    read_fields(e, config, mappings{});
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = e.version.load(std::memory_order_relaxed);
+    return (before == after && before % 2 == 0) ? snapshot::consistent : snapshot::mixed;
+  }
+
+  /**
+   * Reads again until the snapshot is consistent : lock-free, no longer wait-free.
+   */
+  bool read_consistent(size_t address, Config& config) const {
+    for (;;) {
+      switch (read(address, config)) {
+        case snapshot::absent: return false;
+        case snapshot::consistent: return true;
+        case snapshot::mixed: continue;
+      }
+    }
+  }
+
+  /**
+   * Even, and incremented by two each time a frame was decoded in the entry. 0 past the table.
+   */
+  uint64_t version(size_t address) const {
+    return (address < Addresses) ? entries_[address].version.load(std::memory_order_acquire) : 0;
+  }
+
+  static constexpr size_t size() { return Addresses; }
+
+private:
+
+  template <size_t I>
+  using anchor = std::integral_constant<size_t, I>;
+
+  template <size_t I>
+  using flat = flat_type<std::decay_t<decltype(mapping::dest_value(anchor<I>{}, std::declval<const Config&>()))>>;
+
+  template <class Sequence>
+  struct fields_of;
+
+  template <size_t... I>
+  struct fields_of<std::index_sequence<I...>> {
+    using type = std::tuple<std::atomic<typename flat<I>::type>...>;
+  };
+
+  struct alignas(64) entry {
+    std::atomic<uint64_t> version{0};
+    std::atomic<bool> present{false};
+    typename fields_of<mappings>::type fields{};
+  };
+
+  template <size_t... I>
+  size_t update_fields(entry& e, const Binary& frame, bool all, std::index_sequence<I...>) {
+    size_t changed = 0;
+    auto update_field = [&](auto id) {
+      constexpr size_t i = decltype(id)::value;
+      mapping::fill(id, frame, scratch_);
+      const auto value = flat<i>::to(mapping::dest_value(id, scratch_));
+      auto& field = std::get<i>(e.fields);
+      if (all || field.load(std::memory_order_relaxed) != value) {
+        field.store(value, std::memory_order_relaxed);
+        ++changed;
+      }
+    };
+    (update_field(anchor<I>{}), ...);
+    return changed;
+  }
+
+  template <size_t... I>
+  void read_fields(const entry& e, Config& config, std::index_sequence<I...>) const {
+    ((mapping::dest_field(anchor<I>{}, config) =
+        flat<I>::from(std::get<I>(e.fields).load(std::memory_order_relaxed))), ...);
+  }
+
+  std::array<entry, Addresses> entries_;
+
+  // Only touched by the writer, holds the field being decoded.
+  Config scratch_;
+};
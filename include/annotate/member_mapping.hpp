@@ -0,0 +1,506 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <utility>
+#include <type_traits>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/seq.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
+#include <boost/preprocessor/tuple/size.hpp>
+
+#include "./wire_cast.hpp"
+
+template <class SRC, class DEST>
+struct member_mapping : public std::false_type {};
+
+/**
+ * How the bytes of a wire field W give the model field M : copied as they are, copied swapping each element,
+ * or not at all, the field then goes through its fill and update. Integrals of the same size are copied as
+ * they are, like static_cast converts them, unless a wire_caster specialization converts them otherwise ; wire
+ * types with a byte order specialize it (see byte_order.hpp).
+ */
+enum class copy_kind { transform, identity, swap };
+
+template <class W, class M>
+constexpr bool plain_casts = wire_cast_plain<M, W>::value && wire_cast_plain<W, M>::value;
+
+template <class W, class M, class Enable = void>
+struct byte_mapping {
+  static constexpr bool same_bits = plain_casts<W, M> &&
+    ((std::is_same<W, M>::value && std::is_trivially_copyable<W>::value) ||
+     (std::is_integral<W>::value && std::is_integral<M>::value && sizeof(W) == sizeof(M) &&
+      !std::is_same<W, bool>::value && !std::is_same<M, bool>::value));
+  static constexpr copy_kind kind = same_bits ? copy_kind::identity : copy_kind::transform;
+  static constexpr size_t element = sizeof(W);
+};
+
+/**
+ * Bytes a mapping copies without its fill and update : both fields have an address, so that each is a plain
+ * byte range at a constant offset on its side.
+ */
+struct copy_span {
+  copy_kind kind = copy_kind::transform;
+  size_t src = 0;
+  size_t dest = 0;
+  size_t size = 0;
+  size_t element = 0;
+};
+
+template <class S, class D>
+constexpr copy_span make_copy_span(size_t src, size_t dest) {
+  using src_field = std::remove_reference_t<S>;
+  using dest_field = std::remove_reference_t<D>;
+  using bytes = byte_mapping<src_field, dest_field>;
+  if (std::is_const<src_field>::value || std::is_const<dest_field>::value || bytes::kind == copy_kind::transform) {
+    return {};
+  }
+  return copy_span{ bytes::kind, src, dest, sizeof(src_field), bytes::element };
+}
+
+/**
+ * Bytes of a model field : compared and hashed as they are when the value is all its bytes hold, i.e. when it
+ * has no padding and no two representations of a value (floats have two zeros).
+ */
+struct dest_bytes {
+  size_t offset = 0;
+  size_t size = 0;
+  bool bytewise = false;
+};
+
+template <class D>
+constexpr dest_bytes make_dest_bytes(size_t offset) {
+  using dest_field = std::remove_reference_t<D>;
+  return dest_bytes{ offset, sizeof(dest_field),
+                     std::has_unique_object_representations<std::remove_cv_t<dest_field>>::value };
+}
+
+/**
+ * dest_span locates the model field of a mapping, whatever its binary side, the fallback overload is for
+ * model fields without an address.
+ */
+#define MEMBER_MAP_DEST_SPAN(id, destpath)                                                                     \
+  template <class D = dest_type>                                                                               \
+  static constexpr auto dest_span(std::integral_constant<size_t, id>, int, D* d = nullptr)                     \
+    -> decltype(&d-> destpath, dest_bytes{}) {                                                                 \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")                    \
+    return make_dest_bytes<decltype(d-> destpath)>(offsetof(D, destpath));                                     \
+    _Pragma("GCC diagnostic pop")                                                                              \
+  }                                                                                                            \
+  static constexpr dest_bytes dest_span(std::integral_constant<size_t, id>, long) { return {}; }
+
+/**
+ * The value of T with every bit set, for a field of type T : a bitfield keeps the bits of its width.
+ */
+template <class T>
+constexpr T wire_ones() {
+  if constexpr (std::is_same<T, bool>::value) {
+    return true;
+  } else if constexpr (std::is_enum<T>::value) {
+    return static_cast<T>(wire_ones<std::underlying_type_t<T>>());
+  } else {
+    return static_cast<T>(~std::make_unsigned_t<T>{ 0 });
+  }
+}
+
+/**
+ * mark_source sets, in a frame of zeros, the bits the binary field of a mapping occupies : all its bytes when
+ * it has an address, its bits otherwise (bitfields). They are the bits its decoding depends on, however lossy
+ * the conversion to the model field is.
+ */
+#define MEMBER_MAP_SRC_MARK(id, srcpath)                                                                       \
+  template <class S = src_type>                                                                                \
+  static auto mark_source(std::integral_constant<size_t, id>, int, S& s) -> decltype(&s. srcpath, void()) {    \
+    std::memset(&s. srcpath, 0xFF, sizeof(s. srcpath));                                                        \
+  }                                                                                                            \
+  template <class S = src_type>                                                                                \
+  static void mark_source(std::integral_constant<size_t, id>, long, S& s) {                                    \
+    s. srcpath = wire_ones<decltype(s. srcpath)>();                                                            \
+  }
+
+/**
+ * Each mapping gets an anchor, std::integral_constant<size_t, id>, which selects its overloads :
+ *  - fill decodes the binary field into the model field, update encodes it back.
+ *  - decode_value and encode_value do the same on a value of the model field, without a model object.
+ *  - dest_value and dest_field access the model field, dest_name is its path as written in map_to, src_name
+ *    the path of the binary field.
+ *  - dest_span locates the model field, see MEMBER_MAP_DEST_SPAN, mark_source the binary field, see
+ *    MEMBER_MAP_SRC_MARK.
+ *  - field_span locates the field on both sides when its bytes are copied. Bitfields have no address, the
+ *    fallback overload says so. Models deriving from their common fields are not standard layout, but have
+ *    no virtual base : offsetof is exact on them and its warning is silenced.
+ */
+#define member_map(id, srcpath, destpath)                                                                      \
+  template <class S = src_type, class D = dest_type>                                                           \
+  static constexpr auto field_span(std::integral_constant<size_t, id>, int, S* s = nullptr, D* d = nullptr)    \
+    -> decltype(&s-> srcpath, &d-> destpath, copy_span{}) {                                                    \
+    _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")                    \
+    return make_copy_span<decltype(s-> srcpath), decltype(d-> destpath)>(                                      \
+      offsetof(S, srcpath), offsetof(D, destpath));                                                            \
+    _Pragma("GCC diagnostic pop")                                                                              \
+  }                                                                                                            \
+  static constexpr copy_span field_span(std::integral_constant<size_t, id>, long) { return {}; }               \
+  static void fill(std::integral_constant<size_t, id>, const src_type& s, dest_type& d) {                      \
+    d. destpath = wire_cast<decltype(d. destpath)>(s. srcpath);                                                \
+  }                                                                                                            \
+  static void update(std::integral_constant<size_t, id>, src_type& s, const dest_type& d) {                    \
+    s. srcpath = wire_cast<decltype(s. srcpath)>(d. destpath);                                                 \
+  }                                                                                                            \
+  static std::decay_t<decltype(std::declval<dest_type&>(). destpath)>                                          \
+  decode_value(std::integral_constant<size_t, id>, const src_type& s) {                                        \
+    return wire_cast<std::decay_t<decltype(std::declval<dest_type&>(). destpath)>>(s. srcpath);                \
+  }                                                                                                            \
+  static void encode_value(std::integral_constant<size_t, id>, src_type& s,                                    \
+                           const std::decay_t<decltype(std::declval<dest_type&>(). destpath)>& v) {            \
+    s. srcpath = wire_cast<decltype(s. srcpath)>(v);                                                           \
+  }                                                                                                            \
+  static decltype(std::declval<dest_type>(). destpath)                                                         \
+  dest_value(std::integral_constant<size_t, id>, const dest_type& d) {                                         \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static auto& dest_field(std::integral_constant<size_t, id>, dest_type& d) {                                  \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static constexpr const char* dest_name(std::integral_constant<size_t, id>) {                                 \
+    return BOOST_PP_STRINGIZE(destpath);                                                                       \
+  }                                                                                                            \
+  static constexpr const char* src_name(std::integral_constant<size_t, id>) {                                  \
+    return BOOST_PP_STRINGIZE(srcpath);                                                                        \
+  }                                                                                                            \
+  MEMBER_MAP_SRC_MARK(id, srcpath)                                                                             \
+  MEMBER_MAP_DEST_SPAN(id, destpath)
+
+/**
+ * A column mapped onto one member of every element of an array has no model field of its own : besides fill,
+ * update and mark_source, it has the column counterparts of the field anchors.
+ *  - dest_column gathers the values of the model column, decode_column and encode_column convert them from and
+ *    to the binary column, without a model object.
+ *  - column_name is "destarray[].member".
+ */
+#define member_map_each(id, srccolumn, destarray, member)                                                       \
+  static void fill(std::integral_constant<size_t, id>, const src_type& s, dest_type& d) {                      \
+    fill_column(s. srccolumn, d. destarray, [](auto& e) -> auto& { return e. member; });                       \
+  }                                                                                                            \
+  static void update(std::integral_constant<size_t, id>, src_type& s, const dest_type& d) {                    \
+    update_column(s. srccolumn, d. destarray, [](auto& e) -> auto& { return e. member; });                     \
+  }                                                                                                            \
+  static auto dest_column(std::integral_constant<size_t, id>, const dest_type& d) {                            \
+    return gather_column(d. destarray, [](auto& e) -> auto& { return e. member; });                            \
+  }                                                                                                            \
+  static auto decode_column(std::integral_constant<size_t, id>, const src_type& s) {                           \
+    using values = decltype(dest_column(std::integral_constant<size_t, id>{},                                  \
+                                        std::declval<const dest_type&>()));                                    \
+    return wire_cast<values>(s. srccolumn);                                                                    \
+  }                                                                                                            \
+  template <class Values>                                                                                      \
+  static void encode_column(std::integral_constant<size_t, id>, src_type& s, const Values& values) {           \
+    s. srccolumn = wire_cast<decltype(s. srccolumn)>(values);                                                  \
+  }                                                                                                            \
+  static constexpr const char* column_name(std::integral_constant<size_t, id>) {                               \
+    return BOOST_PP_STRINGIZE(destarray) "[]." BOOST_PP_STRINGIZE(member);                                     \
+  }                                                                                                            \
+  MEMBER_MAP_SRC_MARK(id, srccolumn)
+
+/**
+ * ((srcpath, destpath)) maps one field, or a whole column onto a whole array.
+ * ((srccolumn, destarray, member)) maps a column onto the given member of each element of an array.
+ */
+#define MEMBER_MAPPINGS_ON_EACH(r, data, i, elem) \
+  BOOST_PP_CAT(MEMBER_MAPPINGS_ARITY_, BOOST_PP_TUPLE_SIZE(elem))(i, elem)
+
+#define MEMBER_MAPPINGS_ARITY_2(i, elem) \
+  member_map( i,  BOOST_PP_TUPLE_ELEM( 2, 0, elem), BOOST_PP_TUPLE_ELEM(2, 1, elem) )
+
+#define MEMBER_MAPPINGS_ARITY_3(i, elem) \
+  member_map_each( i, BOOST_PP_TUPLE_ELEM(3, 0, elem), BOOST_PP_TUPLE_ELEM(3, 1, elem), BOOST_PP_TUPLE_ELEM(3, 2, elem) )
+
+#define map_to(SRC_TYPE, DEST_TYPE, MAPPINGS)                   \
+  template<>                                                    \
+  struct member_mapping<SRC_TYPE, DEST_TYPE> : public std::true_type { \
+                                                                \
+    typedef SRC_TYPE src_type;                                  \
+    typedef DEST_TYPE dest_type;                                \
+                                                                \
+    typedef std::make_index_sequence<BOOST_PP_SEQ_SIZE(MAPPINGS)> mappings; \
+                                                                \
+    BOOST_PP_SEQ_FOR_EACH_I(MEMBER_MAPPINGS_ON_EACH, _, MAPPINGS )    \
+  };                                                            \
+
+/**
+ * dest_name of a mapping, nullptr for the mappings without one (member_map_each).
+ */
+template <class Mapping, size_t I>
+constexpr auto dest_name_of(int) -> decltype(Mapping::dest_name(std::integral_constant<size_t, I>{})) {
+  return Mapping::dest_name(std::integral_constant<size_t, I>{});
+}
+
+template <class Mapping, size_t I>
+constexpr const char* dest_name_of(long) { return nullptr; }
+
+/**
+ * column_name of a mapping, nullptr for the mappings which are not a member_map_each column.
+ */
+template <class Mapping, size_t I>
+constexpr auto column_name_of(int) -> decltype(Mapping::column_name(std::integral_constant<size_t, I>{})) {
+  return Mapping::column_name(std::integral_constant<size_t, I>{});
+}
+
+template <class Mapping, size_t I>
+constexpr const char* column_name_of(long) { return nullptr; }
+
+template <class Mapping, size_t I>
+constexpr auto src_name_of(int) -> decltype(Mapping::src_name(std::integral_constant<size_t, I>{})) {
+  return Mapping::src_name(std::integral_constant<size_t, I>{});
+}
+
+template <class Mapping, size_t I>
+constexpr const char* src_name_of(long) { return nullptr; }
+
+/**
+ * dest_span of a mapping, an empty span for the mappings without one.
+ */
+template <class Mapping, size_t I>
+constexpr auto dest_span_of(int) -> decltype(Mapping::dest_span(std::integral_constant<size_t, I>{}, 0)) {
+  return Mapping::dest_span(std::integral_constant<size_t, I>{}, 0);
+}
+
+template <class Mapping, size_t I>
+constexpr dest_bytes dest_span_of(long) { return {}; }
+
+/**
+ * mark_source of a mapping, the whole frame for the mappings which do not locate their binary field.
+ */
+template <class Mapping, size_t I>
+auto mark_source_of(typename Mapping::src_type& mask, int)
+  -> decltype(Mapping::mark_source(std::integral_constant<size_t, I>{}, 0, mask)) {
+  Mapping::mark_source(std::integral_constant<size_t, I>{}, 0, mask);
+}
+
+template <class Mapping, size_t I>
+void mark_source_of(typename Mapping::src_type& mask, long) {
+  std::memset(&mask, 0xFF, sizeof(mask));
+}
+
+/**
+ * The copy plan of a mapping, computed at compile time : the fields whose bytes are copied, sorted by source
+ * offset, merged in runs while they stay contiguous on both sides with the same kind of copy, and the same
+ * element size for swaps. A run is one memcpy of a constant size, which the compiler turns into a few wide
+ * moves, or one swap_copy ; only the other fields go through their fill and update.
+ */
+template <size_t N>
+struct copy_runs {
+  std::array<copy_span, N> runs{};
+  size_t count = 0;
+};
+
+template <size_t N>
+constexpr copy_runs<N> make_copy_runs(const std::array<copy_span, N>& spans) {
+  std::array<copy_span, N> sorted{};
+  size_t copied = 0;
+  for (size_t i = 0; i < N; ++i) {
+    if (spans[i].kind == copy_kind::transform) { continue; }
+    size_t j = copied++;
+    for (; j > 0 && sorted[j - 1].src > spans[i].src; --j) { sorted[j] = sorted[j - 1]; }
+    sorted[j] = spans[i];
+  }
+
+  copy_runs<N> plan;
+  for (size_t i = 0; i < copied; ++i) {
+    const bool follows = plan.count &&
+      plan.runs[plan.count - 1].kind == sorted[i].kind &&
+      (sorted[i].kind == copy_kind::identity || plan.runs[plan.count - 1].element == sorted[i].element) &&
+      plan.runs[plan.count - 1].src + plan.runs[plan.count - 1].size == sorted[i].src &&
+      plan.runs[plan.count - 1].dest + plan.runs[plan.count - 1].size == sorted[i].dest;
+    if (follows) {
+      plan.runs[plan.count - 1].size += sorted[i].size;
+    } else {
+      plan.runs[plan.count++] = sorted[i];
+    }
+  }
+  return plan;
+}
+
+/**
+ * native : every field is copied as it is, the frame is a blob of the model fields.
+ * swapped : some fields only need their bytes swapped, none needs per field code.
+ * mixed : some fields need their fill and update.
+ */
+enum class frame_class { native, swapped, mixed };
+
+template <size_t N>
+constexpr frame_class classify(const std::array<copy_span, N>& spans) {
+  frame_class c = frame_class::native;
+  for (size_t i = 0; i < N; ++i) {
+    if (spans[i].kind == copy_kind::transform) { return frame_class::mixed; }
+    if (spans[i].kind == copy_kind::swap) { c = frame_class::swapped; }
+  }
+  return c;
+}
+
+/**
+ * Copies Size bytes swapping each element of Element bytes : 16 bytes per pshufb where SSSE3 is available, one
+ * bswap per element for the rest.
+ */
+template <size_t Element>
+struct swap_word;
+template <> struct swap_word<2> { static uint16_t swap(uint16_t v) { return __builtin_bswap16(v); } };
+template <> struct swap_word<4> { static uint32_t swap(uint32_t v) { return __builtin_bswap32(v); } };
+template <> struct swap_word<8> { static uint64_t swap(uint64_t v) { return __builtin_bswap64(v); } };
+
+template <size_t Element, size_t Size>
+inline void swap_copy(char* to, const char* from) {
+  static_assert(Size % Element == 0, "whole elements");
+  size_t i = 0;
+#ifdef __SSSE3__
+  if constexpr (Size >= 16) {
+    alignas(16) static constexpr std::array<char, 16> reverse = [] {
+      std::array<char, 16> mask{};
+      for (size_t b = 0; b < 16; ++b) {
+        mask[b] = static_cast<char>(b / Element * Element + Element - 1 - b % Element);
+      }
+      return mask;
+    }();
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(reverse.data()));
+    for (; i + 16 <= Size; i += 16) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i), _mm_shuffle_epi8(v, shuffle));
+    }
+  }
+#endif
+  for (; i < Size; i += Element) {
+    decltype(swap_word<Element>::swap(0)) word;
+    std::memcpy(&word, from + i, Element);
+    word = swap_word<Element>::swap(word);
+    std::memcpy(to + i, &word, Element);
+  }
+}
+
+template <copy_kind Kind, size_t Element, size_t Size>
+inline void copy_run(char* to, const char* from) {
+  if constexpr (Kind == copy_kind::swap) {
+    swap_copy<Element, Size>(to, from);
+  } else {
+    std::memcpy(to, from, Size);
+  }
+}
+
+// Mappings which are not member_map (member_map_each, generated layouts) never copy unchanged.
+template <class Mapping, size_t I>
+constexpr auto field_span_of(int) -> decltype(Mapping::field_span(std::integral_constant<size_t, I>{}, 0)) {
+  return Mapping::field_span(std::integral_constant<size_t, I>{}, 0);
+}
+
+template <class Mapping, size_t I>
+constexpr copy_span field_span_of(long) { return {}; }
+
+template <class SRC, class DEST>
+struct copy_plan {
+  using mapping = member_mapping<SRC, DEST>;
+
+  template <size_t... I>
+  static constexpr std::array<copy_span, sizeof...(I)> spans_of(std::index_sequence<I...>) {
+    return {{ field_span_of<mapping, I>(0)... }};
+  }
+
+  static constexpr auto spans = spans_of(typename mapping::mappings{});
+  static constexpr auto runs = make_copy_runs(spans);
+  static constexpr frame_class layout = classify(spans);
+  using run_indices = std::make_index_sequence<runs.count>;
+};
+
+/**
+ * Entry points of the codec of a mapping : fill_all and update_all for the struct, fill_run and update_run for
+ * each run of its copy plan, fill_field and update_field for each field converted on its own. With
+ * -DANNOTATE_PROFILE they are never inlined, so that a sampling profiler charges each of them its own samples,
+ * under a name telling the mapping and the run or field index (see profile_map.hpp). Without it they are inline
+ * and the codec compiles as one piece.
+ */
+#ifdef ANNOTATE_PROFILE
+#define ANNOTATE_ENTRY_POINT __attribute__((noinline))
+constexpr bool profile_enabled = true;
+#else
+#define ANNOTATE_ENTRY_POINT inline
+constexpr bool profile_enabled = false;
+#endif
+
+/**
+ * Runs every member_map of a mapping : fill_all decodes the binary into the model, update_all encodes it.
+ * The explicit index_sequence overloads run exactly the given mappings, field by field.
+ */
+template <class SRC, class DEST, size_t... I>
+inline void fill_all(const SRC& s, DEST& d, std::index_sequence<I...>) {
+  (member_mapping<SRC, DEST>::fill(std::integral_constant<size_t, I>{}, s, d), ...);
+}
+
+template <class SRC, class DEST, size_t I>
+ANNOTATE_ENTRY_POINT void fill_field(const SRC& s, DEST& d) {
+  member_mapping<SRC, DEST>::fill(std::integral_constant<size_t, I>{}, s, d);
+}
+
+template <class SRC, class DEST, size_t I>
+inline void fill_transformed(const SRC& s, DEST& d) {
+  if constexpr (copy_plan<SRC, DEST>::spans[I].kind == copy_kind::transform) {
+    fill_field<SRC, DEST, I>(s, d);
+  }
+}
+
+template <class SRC, class DEST, size_t R>
+ANNOTATE_ENTRY_POINT void fill_run(const SRC& s, DEST& d) {
+  constexpr auto& run = copy_plan<SRC, DEST>::runs.runs[R];
+  copy_run<run.kind, run.element, run.size>(reinterpret_cast<char*>(&d) + run.dest,
+                                            reinterpret_cast<const char*>(&s) + run.src);
+}
+
+template <class SRC, class DEST, size_t... R, size_t... I>
+inline void fill_planned(const SRC& s, DEST& d, std::index_sequence<R...>, std::index_sequence<I...>) {
+  (fill_run<SRC, DEST, R>(s, d), ...);
+  (fill_transformed<SRC, DEST, I>(s, d), ...);
+}
+
+template <class SRC, class DEST>
+ANNOTATE_ENTRY_POINT void fill_all(const SRC& s, DEST& d) {
+  fill_planned(s, d, typename copy_plan<SRC, DEST>::run_indices{}, typename member_mapping<SRC, DEST>::mappings{});
+}
+
+template <class SRC, class DEST, size_t... I>
+inline void update_all(SRC& s, const DEST& d, std::index_sequence<I...>) {
+  (member_mapping<SRC, DEST>::update(std::integral_constant<size_t, I>{}, s, d), ...);
+}
+
+template <class SRC, class DEST, size_t I>
+ANNOTATE_ENTRY_POINT void update_field(SRC& s, const DEST& d) {
+  member_mapping<SRC, DEST>::update(std::integral_constant<size_t, I>{}, s, d);
+}
+
+template <class SRC, class DEST, size_t I>
+inline void update_transformed(SRC& s, const DEST& d) {
+  if constexpr (copy_plan<SRC, DEST>::spans[I].kind == copy_kind::transform) {
+    update_field<SRC, DEST, I>(s, d);
+  }
+}
+
+template <class SRC, class DEST, size_t R>
+ANNOTATE_ENTRY_POINT void update_run(SRC& s, const DEST& d) {
+  constexpr auto& run = copy_plan<SRC, DEST>::runs.runs[R];
+  copy_run<run.kind, run.element, run.size>(reinterpret_cast<char*>(&s) + run.src,
+                                            reinterpret_cast<const char*>(&d) + run.dest);
+}
+
+template <class SRC, class DEST, size_t... R, size_t... I>
+inline void update_planned(SRC& s, const DEST& d, std::index_sequence<R...>, std::index_sequence<I...>) {
+  (update_run<SRC, DEST, R>(s, d), ...);
+  (update_transformed<SRC, DEST, I>(s, d), ...);
+}
+
+template <class SRC, class DEST>
+ANNOTATE_ENTRY_POINT void update_all(SRC& s, const DEST& d) {
+  update_planned(s, d, typename copy_plan<SRC, DEST>::run_indices{},
+                 typename member_mapping<SRC, DEST>::mappings{});
+}
@@ -0,0 +1,543 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/seq.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/seq/enum.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
+#include <boost/preprocessor/tuple/size.hpp>
+
+#include "./wire_cast.hpp"
+#include "./member_mapping.hpp"
+
+/*
+ * Modbus register image
+ *
+ * Rationale : A fieldbus master polls ranges of registers, not fields. modbus_map() projects a model on the two
+ *             read/write tables of a Modbus slave : the holding registers, 16 bits words, and the coils, bits.
+ *             Each field gets consecutive registers in declaration order (multi-register values high word
+ *             first), each bool a coil. The image keeps the registers in host order, the big endian swap is
+ *             done on whole ranges when they are copied to or from a PDU.
+ *
+ *             A range_plan computed once for a range knows which fields it touches : a transfer encodes or
+ *             decodes only those fields, through a jump table, then moves the whole range in one swapping
+ *             copy, however many fields it spans. The master splits the image in the largest transfers the
+ *             protocol allows, the fake_slave answers PDUs in process, for tests.
+ */
+namespace modbus {
+
+  enum class exception : uint8_t {
+    none = 0x00,
+    illegal_function = 0x01,
+    illegal_data_address = 0x02,
+    illegal_data_value = 0x03
+  };
+
+  constexpr uint8_t read_coils = 0x01;
+  constexpr uint8_t read_holding_registers = 0x03;
+  constexpr uint8_t write_multiple_coils = 0x0F;
+  constexpr uint8_t write_multiple_registers = 0x10;
+
+  constexpr size_t max_read_registers = 125;
+  constexpr size_t max_write_registers = 123;
+  constexpr size_t max_read_coils = 2000;
+  constexpr size_t max_write_coils = 1968;
+
+  // Function code, byte count and the largest payload.
+  constexpr size_t max_pdu_size = 253;
+
+  /**
+   * Registers of a model field when modbus_map() is not given a count.
+   */
+  template <class T, class Enable = void>
+  struct default_registers {
+    static_assert(sizeof(T) == 0, "no default register count for this model type, give it in modbus_map()");
+  };
+
+  template <class T>
+  struct default_registers<T, std::enable_if_t<(std::is_integral<T>::value || std::is_enum<T>::value) &&
+                                               !std::is_same<T, bool>::value>>
+    : std::integral_constant<size_t, (sizeof(T) + 1) / 2> {};
+
+  /**
+   * First register of each field and number of registers of the image.
+   */
+  template <size_t N>
+  struct address_plan {
+    std::array<size_t, N> addresses{};
+    size_t registers = 0;
+  };
+
+  template <size_t N>
+  constexpr address_plan<N> make_address_plan(const std::array<size_t, N>& counts) {
+    address_plan<N> plan;
+    for (size_t i = 0; i < N; ++i) {
+      plan.addresses[i] = plan.registers;
+      plan.registers += counts[i];
+    }
+    return plan;
+  }
+
+  inline uint64_t read_words(const uint16_t* words, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) { value = (value << 16) | words[i]; }
+    return value;
+  }
+
+  inline void write_words(uint16_t* words, size_t count, uint64_t value) {
+    for (size_t i = count; i > 0; --i) {
+      words[i - 1] = static_cast<uint16_t>(value);
+      value >>= 16;
+    }
+  }
+
+  /**
+   * Swapping copies of a whole range : no dependency between words, the compiler vectorizes them.
+   */
+  inline void to_big_endian(const uint16_t* words, size_t count, uint8_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+      out[2 * i] = static_cast<uint8_t>(words[i] >> 8);
+      out[2 * i + 1] = static_cast<uint8_t>(words[i]);
+    }
+  }
+
+  inline void from_big_endian(const uint8_t* in, size_t count, uint16_t* words) {
+    for (size_t i = 0; i < count; ++i) {
+      words[i] = static_cast<uint16_t>((in[2 * i] << 8) | in[2 * i + 1]);
+    }
+  }
+
+  /**
+   * count bits from bit start of bits, packed LSB first from the first byte of out, like Modbus packs coils.
+   */
+  inline void extract_bits(const uint8_t* bits, size_t size, size_t start, size_t count, uint8_t* out) {
+    const size_t shift = start % 8;
+    for (size_t k = 0; k < (count + 7) / 8; ++k) {
+      const size_t byte = start / 8 + k;
+      unsigned value = bits[byte] >> shift;
+      if (shift && byte + 1 < size) { value |= unsigned{bits[byte + 1]} << (8 - shift); }
+      const size_t left = count - 8 * k;
+      out[k] = static_cast<uint8_t>(left >= 8 ? value : value & ((1u << left) - 1));
+    }
+  }
+
+  inline void insert_bits(const uint8_t* in, size_t count, uint8_t* bits, size_t start) {
+    for (size_t i = 0; i < count; ++i) {
+      const size_t bit = start + i;
+      const uint8_t mask = static_cast<uint8_t>(1u << (bit % 8));
+      if ((in[i / 8] >> (i % 8)) & 1) { bits[bit / 8] |= mask; } else { bits[bit / 8] &= ~mask; }
+    }
+  }
+
+  /**
+   * Fields touched by a range : [first_field, end_field) have at least one register or coil in it,
+   * [first_whole, end_whole) all of them, only those can be decoded after a write.
+   */
+  struct range_plan {
+    size_t start = 0;
+    size_t count = 0;
+    size_t first_field = 0;
+    size_t end_field = 0;
+    size_t first_whole = 0;
+    size_t end_whole = 0;
+  };
+
+  template <class Image>
+  class fields {
+  public:
+    using dest_type = typename Image::dest_type;
+    using mapping = member_mapping<Image, dest_type>;
+
+    static bool plan_registers(size_t start, size_t count, range_plan& plan) {
+      if (count == 0 || start + count > Image::holding_registers) { return false; }
+      const auto& addresses = Image::plan.addresses;
+      auto field_end = [&](size_t i) { return addresses[i] + Image::register_counts[i]; };
+
+      plan.start = start;
+      plan.count = count;
+      // The first field ending after start, the first field starting at or after the end.
+      plan.first_field = std::upper_bound(addresses.begin(), addresses.end(), start) - addresses.begin() - 1;
+      plan.end_field = std::lower_bound(addresses.begin(), addresses.end(), start + count) - addresses.begin();
+      plan.first_whole = (addresses[plan.first_field] == start) ? plan.first_field : plan.first_field + 1;
+      plan.end_whole = plan.end_field;
+      if (plan.end_whole > plan.first_whole && field_end(plan.end_whole - 1) > start + count) { --plan.end_whole; }
+      return true;
+    }
+
+    static bool plan_coils(size_t start, size_t count, range_plan& plan) {
+      if (count == 0 || start + count > Image::coils) { return false; }
+      plan.start = start;
+      plan.count = count;
+      plan.first_field = plan.first_whole = Image::register_fields + start;
+      plan.end_field = plan.end_whole = Image::register_fields + start + count;
+      return true;
+    }
+
+    static void encode(const range_plan& plan, const dest_type& config, Image& image) {
+      for (size_t i = plan.first_field; i < plan.end_field; ++i) { updates()[i](image, config); }
+    }
+
+    static void decode(const range_plan& plan, const Image& image, dest_type& config) {
+      for (size_t i = plan.first_whole; i < plan.end_whole; ++i) { fills()[i](image, config); }
+    }
+
+  private:
+    static constexpr size_t count = Image::register_fields + Image::coils;
+
+    using fill_fn = void (*)(const Image&, dest_type&);
+    using update_fn = void (*)(Image&, const dest_type&);
+
+    template <size_t I>
+    static void fill_one(const Image& image, dest_type& config) {
+      mapping::fill(std::integral_constant<size_t, I>{}, image, config);
+    }
+
+    template <size_t I>
+    static void update_one(Image& image, const dest_type& config) {
+      mapping::update(std::integral_constant<size_t, I>{}, image, config);
+    }
+
+    template <size_t... I>
+    static const std::array<fill_fn, count>& fills(std::index_sequence<I...>) {
+      static constexpr std::array<fill_fn, count> table{{ &fill_one<I>... }};
+      return table;
+    }
+
+    template <size_t... I>
+    static const std::array<update_fn, count>& updates(std::index_sequence<I...>) {
+      static constexpr std::array<update_fn, count> table{{ &update_one<I>... }};
+      return table;
+    }
+
+    static const std::array<fill_fn, count>& fills() { return fills(typename mapping::mappings{}); }
+    static const std::array<update_fn, count>& updates() { return updates(typename mapping::mappings{}); }
+  };
+
+  inline void put_u16(uint8_t* p, size_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+  }
+
+  inline size_t get_u16(const uint8_t* p) { return (size_t{p[0]} << 8) | p[1]; }
+
+  /**
+   * In process slave holding a model : answers request PDUs like a device would.
+   */
+  template <class Image>
+  class fake_slave {
+  public:
+    using dest_type = typename Image::dest_type;
+
+    explicit fake_slave(const dest_type& config = dest_type{}) : config_(config), image_{} {}
+
+    /**
+     * \return the size of the response written to response, at least max_pdu_size bytes.
+     */
+    size_t handle(const uint8_t* request, size_t size, uint8_t* response) {
+      ++requests_;
+      if (size < 5) { return refuse(size ? request[0] : 0, exception::illegal_data_value, response); }
+
+      const uint8_t function = request[0];
+      const size_t start = get_u16(request + 1);
+      const size_t count = get_u16(request + 3);
+      range_plan plan;
+
+      switch (function) {
+        case read_holding_registers: {
+          if (count > max_read_registers) { return refuse(function, exception::illegal_data_value, response); }
+          if (!fields<Image>::plan_registers(start, count, plan)) {
+            return refuse(function, exception::illegal_data_address, response);
+          }
+          fields<Image>::encode(plan, config_, image_);
+          response[0] = function;
+          response[1] = static_cast<uint8_t>(2 * count);
+          to_big_endian(image_.registers.data() + start, count, response + 2);
+          return 2 + 2 * count;
+        }
+
+        case write_multiple_registers: {
+          if (count > max_write_registers || size < 6 + 2 * count || request[5] != 2 * count) {
+            return refuse(function, exception::illegal_data_value, response);
+          }
+          if (!fields<Image>::plan_registers(start, count, plan)) {
+            return refuse(function, exception::illegal_data_address, response);
+          }
+          from_big_endian(request + 6, count, image_.registers.data() + start);
+          fields<Image>::decode(plan, image_, config_);
+          std::memcpy(response, request, 5);
+          return 5;
+        }
+
+        case read_coils: {
+          if (count > max_read_coils) { return refuse(function, exception::illegal_data_value, response); }
+          if (!fields<Image>::plan_coils(start, count, plan)) {
+            return refuse(function, exception::illegal_data_address, response);
+          }
+          fields<Image>::encode(plan, config_, image_);
+          response[0] = function;
+          response[1] = static_cast<uint8_t>((count + 7) / 8);
+          extract_bits(image_.coil_bits.data(), image_.coil_bits.size(), start, count, response + 2);
+          return 2 + (count + 7) / 8;
+        }
+
+        case write_multiple_coils: {
+          if (count > max_write_coils || size < 6 + (count + 7) / 8 || request[5] != (count + 7) / 8) {
+            return refuse(function, exception::illegal_data_value, response);
+          }
+          if (!fields<Image>::plan_coils(start, count, plan)) {
+            return refuse(function, exception::illegal_data_address, response);
+          }
+          insert_bits(request + 6, count, image_.coil_bits.data(), start);
+          fields<Image>::decode(plan, image_, config_);
+          std::memcpy(response, request, 5);
+          return 5;
+        }
+
+        default:
+          return refuse(function, exception::illegal_function, response);
+      }
+    }
+
+    const dest_type& config() const { return config_; }
+    dest_type& config() { return config_; }
+    size_t requests() const { return requests_; }
+
+  private:
+    static size_t refuse(uint8_t function, exception code, uint8_t* response) {
+      response[0] = static_cast<uint8_t>(function | 0x80);
+      response[1] = static_cast<uint8_t>(code);
+      return 2;
+    }
+
+    dest_type config_;
+    Image image_;
+    size_t requests_ = 0;
+  };
+
+  /**
+   * Transfers whole models, or ranges of them, in the fewest requests. The transport sends a request PDU and
+   * writes the response PDU, returning its size.
+   */
+  template <class Image>
+  class master {
+  public:
+    using dest_type = typename Image::dest_type;
+    using transport_type = std::function<size_t(const uint8_t* request, size_t size, uint8_t* response)>;
+
+    explicit master(transport_type transport) : transport_(std::move(transport)), image_{} {
+      split(Image::holding_registers, max_read_registers, &fields<Image>::plan_registers, register_reads_);
+      split(Image::holding_registers, max_write_registers, &fields<Image>::plan_registers, register_writes_);
+      split(Image::coils, max_read_coils, &fields<Image>::plan_coils, coil_reads_);
+      split(Image::coils, max_write_coils, &fields<Image>::plan_coils, coil_writes_);
+    }
+
+    exception write(const dest_type& config) {
+      update_all(image_, config);
+      for (const auto& plan : register_writes_) {
+        if (auto e = write_registers(plan); e != exception::none) { return e; }
+      }
+      for (const auto& plan : coil_writes_) {
+        if (auto e = write_coils(plan); e != exception::none) { return e; }
+      }
+      return exception::none;
+    }
+
+    exception read(dest_type& config) {
+      for (const auto& plan : register_reads_) {
+        if (auto e = read_registers(plan, config); e != exception::none) { return e; }
+      }
+      for (const auto& plan : coil_reads_) {
+        if (auto e = read_coils(plan, config); e != exception::none) { return e; }
+      }
+      return exception::none;
+    }
+
+    /**
+     * One request for registers [plan.start, plan.start + plan.count), decodes the fields wholly inside.
+     */
+    exception read_registers(const range_plan& plan, dest_type& config) {
+      uint8_t request[5] = { read_holding_registers };
+      put_u16(request + 1, plan.start);
+      put_u16(request + 3, plan.count);
+
+      const size_t size = transport_(request, sizeof(request), response_.data());
+      if (auto e = check(read_holding_registers, size); e != exception::none) { return e; }
+      if (size != 2 + 2 * plan.count || response_[1] != 2 * plan.count) { return exception::illegal_data_value; }
+
+      from_big_endian(response_.data() + 2, plan.count, image_.registers.data() + plan.start);
+      fields<Image>::decode(plan, image_, config);
+      return exception::none;
+    }
+
+    exception read_coils(const range_plan& plan, dest_type& config) {
+      uint8_t request[5] = { modbus::read_coils };
+      put_u16(request + 1, plan.start);
+      put_u16(request + 3, plan.count);
+
+      const size_t size = transport_(request, sizeof(request), response_.data());
+      if (auto e = check(modbus::read_coils, size); e != exception::none) { return e; }
+      if (size != 2 + (plan.count + 7) / 8) { return exception::illegal_data_value; }
+
+      insert_bits(response_.data() + 2, plan.count, image_.coil_bits.data(), plan.start);
+      fields<Image>::decode(plan, image_, config);
+      return exception::none;
+    }
+
+    /**
+     * Requests sent for a whole read, a whole write.
+     */
+    size_t read_requests() const { return register_reads_.size() + coil_reads_.size(); }
+    size_t write_requests() const { return register_writes_.size() + coil_writes_.size(); }
+
+  private:
+    exception write_registers(const range_plan& plan) {
+      request_[0] = write_multiple_registers;
+      put_u16(request_.data() + 1, plan.start);
+      put_u16(request_.data() + 3, plan.count);
+      request_[5] = static_cast<uint8_t>(2 * plan.count);
+      to_big_endian(image_.registers.data() + plan.start, plan.count, request_.data() + 6);
+      return check(write_multiple_registers, transport_(request_.data(), 6 + 2 * plan.count, response_.data()));
+    }
+
+    exception write_coils(const range_plan& plan) {
+      const size_t bytes = (plan.count + 7) / 8;
+      request_[0] = write_multiple_coils;
+      put_u16(request_.data() + 1, plan.start);
+      put_u16(request_.data() + 3, plan.count);
+      request_[5] = static_cast<uint8_t>(bytes);
+      extract_bits(image_.coil_bits.data(), image_.coil_bits.size(), plan.start, plan.count, request_.data() + 6);
+      return check(write_multiple_coils, transport_(request_.data(), 6 + bytes, response_.data()));
+    }
+
+    exception check(uint8_t function, size_t size) const {
+      if (size >= 2 && response_[0] == (function | 0x80)) { return static_cast<exception>(response_[1]); }
+      if (size < 2 || response_[0] != function) { return exception::illegal_data_value; }
+      return exception::none;
+    }
+
+    template <class Planner>
+    static void split(size_t total, size_t largest, Planner planner, std::vector<range_plan>& plans) {
+      for (size_t start = 0; start < total; start += largest) {
+        range_plan plan;
+        planner(start, std::min(largest, total - start), plan);
+        plans.push_back(plan);
+      }
+    }
+
+    transport_type transport_;
+    Image image_;
+    std::vector<range_plan> register_reads_, register_writes_, coil_reads_, coil_writes_;
+    std::array<uint8_t, max_pdu_size + 1> request_{};
+    std::array<uint8_t, max_pdu_size + 1> response_{};
+  };
+
+}
+
+/**
+ * ((destpath)) takes the default register count of the field, ((destpath, registers)) the given count.
+ */
+#define MODBUS_REGISTER_PATH(elem) BOOST_PP_TUPLE_ELEM(BOOST_PP_TUPLE_SIZE(elem), 0, elem)
+
+#define MODBUS_REGISTER_COUNT(elem) BOOST_PP_CAT(MODBUS_REGISTER_COUNT_, BOOST_PP_TUPLE_SIZE(elem))(elem)
+#define MODBUS_REGISTER_COUNT_1(elem) \
+  modbus::default_registers<std::decay_t<decltype(std::declval<dest_type&>(). BOOST_PP_TUPLE_ELEM(1, 0, elem))>>::value
+#define MODBUS_REGISTER_COUNT_2(elem) BOOST_PP_TUPLE_ELEM(2, 1, elem)
+
+#define MODBUS_REGISTER_COUNTS_ON_EACH(r, data, elem) (MODBUS_REGISTER_COUNT(elem))
+
+#define MODBUS_MAP_FIELD_ACCESSORS(id, destpath)                                                               \
+  static void fill(std::integral_constant<size_t, id>, const src_type& s, dest_type& d) {                      \
+    d. destpath = decode_value(std::integral_constant<size_t, id>{}, s);                                       \
+  }                                                                                                            \
+  static void update(std::integral_constant<size_t, id>, src_type& s, const dest_type& d) {                    \
+    encode_value(std::integral_constant<size_t, id>{}, s, d. destpath);                                        \
+  }                                                                                                            \
+  static decltype(std::declval<dest_type>(). destpath)                                                         \
+  dest_value(std::integral_constant<size_t, id>, const dest_type& d) {                                         \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static auto& dest_field(std::integral_constant<size_t, id>, dest_type& d) {                                  \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static constexpr const char* dest_name(std::integral_constant<size_t, id>) {                                 \
+    return BOOST_PP_STRINGIZE(destpath);                                                                       \
+  }                                                                                                            \
+  MEMBER_MAP_DEST_SPAN(id, destpath)
+
+#define MODBUS_FIELD_TYPE(destpath) std::decay_t<decltype(std::declval<dest_type&>(). destpath)>
+
+#define member_map_register(id, destpath)                                                                      \
+  static MODBUS_FIELD_TYPE(destpath) decode_value(std::integral_constant<size_t, id>, const src_type& s) {     \
+    return wire_cast<MODBUS_FIELD_TYPE(destpath)>(                                                             \
+      modbus::read_words(s.registers.data() + src_type::plan.addresses[id], src_type::register_counts[id]));    \
+  }                                                                                                            \
+  static void encode_value(std::integral_constant<size_t, id>, src_type& s,                                    \
+                           const MODBUS_FIELD_TYPE(destpath)& v) {                                             \
+    modbus::write_words(s.registers.data() + src_type::plan.addresses[id], src_type::register_counts[id],       \
+                        wire_cast<uint64_t>(v));                                                               \
+  }                                                                                                            \
+  static void mark_source(std::integral_constant<size_t, id>, int, src_type& s) {                              \
+    std::fill_n(s.registers.data() + src_type::plan.addresses[id], src_type::register_counts[id], 0xFFFF);     \
+  }                                                                                                            \
+  MODBUS_MAP_FIELD_ACCESSORS(id, destpath)
+
+#define member_map_coil(id, coil, destpath)                                                                    \
+  static MODBUS_FIELD_TYPE(destpath) decode_value(std::integral_constant<size_t, id>, const src_type& s) {     \
+    return wire_cast<MODBUS_FIELD_TYPE(destpath)>(((s.coil_bits[(coil) / 8] >> ((coil) % 8)) & 1) != 0);       \
+  }                                                                                                            \
+  static void encode_value(std::integral_constant<size_t, id>, src_type& s,                                    \
+                           const MODBUS_FIELD_TYPE(destpath)& v) {                                             \
+    const uint8_t mask = static_cast<uint8_t>(1u << ((coil) % 8));                                             \
+    if (wire_cast<bool>(v)) { s.coil_bits[(coil) / 8] |= mask; }                                               \
+    else { s.coil_bits[(coil) / 8] &= static_cast<uint8_t>(~mask); }                                           \
+  }                                                                                                            \
+  static void mark_source(std::integral_constant<size_t, id>, int, src_type& s) {                              \
+    s.coil_bits[(coil) / 8] |= static_cast<uint8_t>(1u << ((coil) % 8));                                       \
+  }                                                                                                            \
+  MODBUS_MAP_FIELD_ACCESSORS(id, destpath)
+
+#define MODBUS_REGISTERS_ON_EACH(r, data, i, elem) member_map_register(i, MODBUS_REGISTER_PATH(elem))
+
+#define MODBUS_COILS_ON_EACH(r, registers, i, elem) \
+  member_map_coil(registers + i, i, BOOST_PP_TUPLE_ELEM(1, 0, elem))
+
+/**
+ * The holding registers of the model are the anchors [0, register_fields), its coils the anchors that follow.
+ */
+#define modbus_map(NAME, DEST_TYPE, REGISTERS, COILS)                                                          \
+  struct NAME {                                                                                                \
+    typedef DEST_TYPE dest_type;                                                                               \
+                                                                                                               \
+    static constexpr size_t register_fields = BOOST_PP_SEQ_SIZE(REGISTERS);                                   \
+    static constexpr std::array<size_t, register_fields> register_counts{{                                    \
+      BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_FOR_EACH(MODBUS_REGISTER_COUNTS_ON_EACH, _, REGISTERS))                  \
+    }};                                                                                                        \
+    static constexpr modbus::address_plan<register_fields> plan = modbus::make_address_plan(register_counts);  \
+    static constexpr size_t holding_registers = plan.registers;                                               \
+    static constexpr size_t coils = BOOST_PP_SEQ_SIZE(COILS);                                                  \
+                                                                                                               \
+    std::array<uint16_t, holding_registers> registers;                                                        \
+    std::array<uint8_t, (coils + 7) / 8> coil_bits;                                                            \
+  };                                                                                                           \
+                                                                                                               \
+  template<>                                                                                                   \
+  struct member_mapping<NAME, DEST_TYPE> : public std::true_type {                                             \
+                                                                                                               \
+    typedef NAME src_type;                                                                                     \
+    typedef DEST_TYPE dest_type;                                                                               \
+                                                                                                               \
+    typedef std::make_index_sequence<BOOST_PP_SEQ_SIZE(REGISTERS) + BOOST_PP_SEQ_SIZE(COILS)> mappings;        \
+                                                                                                               \
+    BOOST_PP_SEQ_FOR_EACH_I(MODBUS_REGISTERS_ON_EACH, _, REGISTERS)                                            \
+    BOOST_PP_SEQ_FOR_EACH_I(MODBUS_COILS_ON_EACH, BOOST_PP_SEQ_SIZE(REGISTERS), COILS)                         \
+  };
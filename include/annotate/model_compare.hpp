@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Equality, ordering and hash of models
+ *
+ * Rationale : Models have no operator== nor hash, so comparing two configs meant encoding both and comparing the
+ *             frames. A mapping knows the model fields it carries : mapped_fields<Binary, Config> compares and
+ *             hashes them, and only them, which leaves out padding as well as fields the wire does not carry.
+ *
+ *             The fields are taken in the order of the model layout. Those whose value is all their bytes hold
+ *             (dest_bytes::bytewise) are merged in runs while they stay contiguous, each run is compared with a
+ *             memcmp of a constant size, which the compiler turns into a few wide loads, and hashed 16 bytes at a
+ *             time with a multiply and fold mix. The other fields use their operator==, operator< and std::hash.
+ *             Ordering is lexicographic in the order of the layout, as a defaulted comparison would be : the runs
+ *             which are equal are skipped whole, only the first different one is compared field by field.
+ *
+ *             member_map_each columns have no model field of their own : their values are gathered with
+ *             dest_column and compared and hashed element by element. A mapping with neither a model field nor
+ *             a column does not compile. mapped_comparisons makes std::hash, std::equal_to and std::less of the
+ *             model use the fields of a mapping, so that it can be the key of unordered_map, map and set as it is.
+ */
+
+/**
+ * A run of fields contiguous in the model, [first, end) of the order of the layout.
+ */
+struct compare_run {
+  size_t offset = 0;
+  size_t size = 0;
+  bool bytewise = false;
+  size_t first = 0;
+  size_t end = 0;
+};
+
+template <size_t N>
+struct compare_runs {
+  std::array<size_t, N> order{};
+  std::array<compare_run, N> runs{};
+  size_t count = 0;
+};
+
+template <size_t N>
+constexpr compare_runs<N> make_compare_runs(const std::array<dest_bytes, N>& spans) {
+  compare_runs<N> plan;
+  size_t placed = 0;
+  for (size_t i = 0; i < N; ++i) {
+    if (spans[i].size == 0) { continue; }
+    size_t j = placed++;
+    for (; j > 0 && spans[plan.order[j - 1]].offset > spans[i].offset; --j) { plan.order[j] = plan.order[j - 1]; }
+    plan.order[j] = i;
+  }
+  for (size_t i = 0; i < N; ++i) {
+    if (spans[i].size == 0) { plan.order[placed++] = i; }
+  }
+
+  for (size_t k = 0; k < N; ++k) {
+    const dest_bytes& field = spans[plan.order[k]];
+    const bool follows = plan.count && field.bytewise && plan.runs[plan.count - 1].bytewise &&
+      plan.runs[plan.count - 1].offset + plan.runs[plan.count - 1].size == field.offset;
+    if (follows) {
+      plan.runs[plan.count - 1].size += field.size;
+      plan.runs[plan.count - 1].end = k + 1;
+    } else {
+      plan.runs[plan.count++] = compare_run{ field.offset, field.size, field.bytewise, k, k + 1 };
+    }
+  }
+  return plan;
+}
+
+/**
+ * 64 bits multiply and fold : the high half of the product mixes every bit of both operands.
+ */
+inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+  const __uint128_t product = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+constexpr uint64_t hash_seed = 0x9E3779B97F4A7C15ull;
+constexpr uint64_t hash_multiplier = 0xE7037ED1A0B428DBull;
+
+/**
+ * 16 bytes per multiply, each word xored with a key of its place in the model, and the mixes summed : they do not
+ * wait for each other, the multiplies of a whole model are in flight at once. Words are loaded where they lie,
+ * the last ones overlapping the previous ones rather than reading past the run, or being assembled in memory.
+ */
+constexpr uint64_t hash_key(size_t place) { return hash_seed * (2 * place + 1); }
+
+inline uint64_t hash_pair(uint64_t first, uint64_t second, size_t place) {
+  return hash_mix(first ^ hash_key(2 * place), second ^ hash_key(2 * place + 1));
+}
+
+template <size_t Size>
+inline uint64_t load_word(const char* bytes) {
+  if constexpr (Size > 4 && Size < 8) {
+    return load_word<4>(bytes) | (load_word<4>(bytes + Size - 4) << 32);
+  } else {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes, Size);
+    return word;
+  }
+}
+
+/**
+ * Hash of one value : its bytes when they are all its value, its std::hash otherwise.
+ */
+template <class T>
+inline uint64_t hash_value(const T& value) {
+  if constexpr (std::has_unique_object_representations<T>::value && sizeof(T) <= 8) {
+    return load_word<sizeof(T)>(reinterpret_cast<const char*>(&value));
+  } else {
+    return std::hash<T>{}(value);
+  }
+}
+
+template <size_t Size, size_t Place>
+inline uint64_t hash_bytes(const char* bytes) {
+  if constexpr (Size < 8) {
+    return hash_pair(load_word<Size>(bytes), 0, Place);
+  } else if constexpr (Size <= 16) {
+    return hash_pair(load_word<8>(bytes), load_word<8>(bytes + Size - 8), Place);
+  } else {
+    uint64_t h = 0;
+    size_t i = 0;
+    for (; i + 16 <= Size; i += 16) {
+      h += hash_pair(load_word<8>(bytes + i), load_word<8>(bytes + i + 8), Place + i);
+    }
+    if constexpr (Size % 16 != 0) {
+      h += hash_pair(load_word<8>(bytes + Size - 16), load_word<8>(bytes + Size - 8), Place + i);
+    }
+    return h;
+  }
+}
+
+template <class Binary, class Config>
+class mapped_fields {
+public:
+
+  using mapping = member_mapping<Binary, Config>;
+  using mappings = typename mapping::mappings;
+  static constexpr size_t fields = mappings::size();
+
+private:
+
+  template <size_t... I>
+  static constexpr std::array<dest_bytes, fields> spans_of(std::index_sequence<I...>) {
+    return {{ dest_span_of<mapping, I>(0)... }};
+  }
+
+public:
+
+  static constexpr std::array<dest_bytes, fields> spans = spans_of(mappings{});
+  static constexpr compare_runs<fields> plan = make_compare_runs(spans);
+  using run_indices = std::make_index_sequence<plan.count>;
+
+  static bool equal(const Config& a, const Config& b) { return equal(a, b, run_indices{}); }
+
+  /**
+   * \return < 0, 0 or > 0 as a is before, equal to or after b.
+   */
+  static int compare(const Config& a, const Config& b) { return compare(a, b, run_indices{}); }
+
+  static bool less(const Config& a, const Config& b) { return compare(a, b) < 0; }
+
+  static size_t hash(const Config& c) {
+    return static_cast<size_t>(hash_mix(hash(c, run_indices{}) ^ hash_seed, hash_multiplier));
+  }
+
+private:
+
+  static const char* bytes(const Config& c) { return reinterpret_cast<const char*>(&c); }
+
+  template <size_t I>
+  static constexpr bool named() { return dest_name_of<mapping, I>(0) != nullptr; }
+
+  template <size_t I>
+  static constexpr bool column() { return column_name_of<mapping, I>(0) != nullptr; }
+
+  template <size_t... I>
+  static constexpr bool comparable(std::index_sequence<I...>) { return ((named<I>() || column<I>()) && ...); }
+
+  static_assert(comparable(mappings{}), "mapped_fields needs the model field or column of every mapping");
+
+  template <size_t I>
+  static bool equal_one(const Config& a, const Config& b) {
+    if constexpr (named<I>()) {
+      return mapping::dest_value(std::integral_constant<size_t, I>{}, a) ==
+             mapping::dest_value(std::integral_constant<size_t, I>{}, b);
+    } else {
+      return mapping::dest_column(std::integral_constant<size_t, I>{}, a) ==
+             mapping::dest_column(std::integral_constant<size_t, I>{}, b);
+    }
+  }
+
+  template <size_t R>
+  static bool equal_run(const Config& a, const Config& b) {
+    constexpr compare_run run = plan.runs[R];
+    if constexpr (run.bytewise) {
+      return std::memcmp(bytes(a) + run.offset, bytes(b) + run.offset, run.size) == 0;
+    } else {
+      return equal_one<plan.order[run.first]>(a, b);
+    }
+  }
+
+  template <size_t... R>
+  static bool equal(const Config& a, const Config& b, std::index_sequence<R...>) {
+    return (equal_run<R>(a, b) && ...);
+  }
+
+  using compare_fn = int (*)(const Config&, const Config&);
+
+  template <size_t I>
+  static int compare_one(const Config& a, const Config& b) {
+    if constexpr (named<I>()) {
+      const auto& x = mapping::dest_value(std::integral_constant<size_t, I>{}, a);
+      const auto& y = mapping::dest_value(std::integral_constant<size_t, I>{}, b);
+      return (x < y) ? -1 : ((y < x) ? 1 : 0);
+    } else {
+      const auto x = mapping::dest_column(std::integral_constant<size_t, I>{}, a);
+      const auto y = mapping::dest_column(std::integral_constant<size_t, I>{}, b);
+      return (x < y) ? -1 : ((y < x) ? 1 : 0);
+    }
+  }
+
+  template <size_t... I>
+  static constexpr std::array<compare_fn, fields> make_compare_table(std::index_sequence<I...>) {
+    return {{ &compare_one<I>... }};
+  }
+
+  static constexpr std::array<compare_fn, fields> compare_table = make_compare_table(mappings{});
+
+  template <size_t R>
+  static int compare_run_of(const Config& a, const Config& b) {
+    constexpr compare_run run = plan.runs[R];
+    if constexpr (run.bytewise) {
+      if (std::memcmp(bytes(a) + run.offset, bytes(b) + run.offset, run.size) == 0) { return 0; }
+    }
+    for (size_t k = run.first; k < run.end; ++k) {
+      if (const int c = compare_table[plan.order[k]](a, b)) { return c; }
+    }
+    return 0;
+  }
+
+  template <size_t... R>
+  static int compare(const Config& a, const Config& b, std::index_sequence<R...>) {
+    int c = 0;
+    static_cast<void>((((c = compare_run_of<R>(a, b)) == 0) && ...));
+    return c;
+  }
+
+  template <size_t R>
+  static uint64_t hash_run(const Config& c) {
+    constexpr compare_run run = plan.runs[R];
+    if constexpr (run.bytewise) {
+      return hash_bytes<run.size, run.offset>(bytes(c) + run.offset);
+    } else {
+      // Fields without an address are placed past the model.
+      constexpr size_t I = plan.order[run.first];
+      constexpr size_t place = run.size ? run.offset : sizeof(Config) + I;
+      if constexpr (named<I>()) {
+        using value_type = std::decay_t<decltype(mapping::dest_value(std::integral_constant<size_t, I>{}, c))>;
+        return hash_pair(std::hash<value_type>{}(mapping::dest_value(std::integral_constant<size_t, I>{}, c)), 0,
+                         place);
+      } else {
+        // Each element is mixed with its index, a permutation of the column hashes differently.
+        const auto values = mapping::dest_column(std::integral_constant<size_t, I>{}, c);
+        uint64_t h = 0;
+        for (size_t k = 0; k < values.size(); ++k) {
+          h += hash_pair(hash_value(values[k]), k, place);
+        }
+        return h;
+      }
+    }
+  }
+
+  template <size_t... R>
+  static uint64_t hash(const Config& c, std::index_sequence<R...>) {
+    return (uint64_t{ 0 } + ... + hash_run<R>(c));
+  }
+};
+
+template <class Binary, class Config>
+constexpr std::array<dest_bytes, mapped_fields<Binary, Config>::fields> mapped_fields<Binary, Config>::spans;
+
+template <class Binary, class Config>
+constexpr compare_runs<mapped_fields<Binary, Config>::fields> mapped_fields<Binary, Config>::plan;
+
+template <class Binary, class Config>
+constexpr std::array<typename mapped_fields<Binary, Config>::compare_fn, mapped_fields<Binary, Config>::fields>
+mapped_fields<Binary, Config>::compare_table;
+
+/**
+ * Function objects for the containers of the standard library.
+ */
+template <class Binary, class Config>
+struct mapped_equal {
+  bool operator()(const Config& a, const Config& b) const { return mapped_fields<Binary, Config>::equal(a, b); }
+};
+
+template <class Binary, class Config>
+struct mapped_less {
+  bool operator()(const Config& a, const Config& b) const { return mapped_fields<Binary, Config>::less(a, b); }
+};
+
+template <class Binary, class Config>
+struct mapped_hash {
+  size_t operator()(const Config& c) const { return mapped_fields<Binary, Config>::hash(c); }
+};
+
+/**
+ * std::hash, std::equal_to and std::less of CONFIG over the fields mapped by BINARY, at global scope.
+ */
+#define mapped_comparisons(BINARY, CONFIG)                                                                     \
+  namespace std {                                                                                              \
+    template <> struct hash<CONFIG> : mapped_hash<BINARY, CONFIG> {};                                          \
+    template <> struct equal_to<CONFIG> : mapped_equal<BINARY, CONFIG> {};                                     \
+    template <> struct less<CONFIG> : mapped_less<BINARY, CONFIG> {};                                          \
+  }
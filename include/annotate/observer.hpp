@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <initializer_list>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Field observer
+ *
+ * Rationale : Consumers of decoded states each want a few fields, and each polled the whole config and diffed
+ *             it against its own copy. field_observer decodes a frame once : before filling the state, it only
+ *             compares the fields somebody subscribed to, decoded from the frame, with the state. Each concerned
+ *             subscriber is then called once per decode with the set of its fields which changed : notifications
+ *             are batched per decode pass, whatever the number of fields.
+ *
+ *             Every field has a bitmap of its subscribers ; the subscribers to call are the union of the
+ *             bitmaps of the changed fields. Only the watched fields are compared, through a jump table : a
+ *             decode with no subscriber is a plain fill_all, fields nobody watches cost nothing more.
+ */
+template <class Binary, class Config, size_t MaxSubscribers = 64>
+class field_observer {
+public:
+
+  using mapping = member_mapping<Binary, Config>;
+  using mappings = typename mapping::mappings;
+  static constexpr size_t fields = mappings::size();
+  static constexpr size_t no_field = static_cast<size_t>(-1);
+
+  using changes = std::bitset<fields>;
+  using subscribers = std::bitset<MaxSubscribers>;
+
+  /**
+   * Called with the device the frame came from, its decoded config and the changed fields of the subscription.
+   */
+  using callback = std::function<void(uint32_t device, const Config& config, const changes& changed)>;
+
+  /**
+   * \return the index of the field named as in map_to, or no_field.
+   */
+  static size_t field_index(const char* name) {
+    for (size_t i = 0; i < fields; ++i) {
+      if (names()[i] && std::strcmp(names()[i], name) == 0) { return i; }
+    }
+    return no_field;
+  }
+
+  /**
+   * \return the subscriber id, to unsubscribe.
+   * \throw std::invalid_argument on an unknown field, std::length_error past MaxSubscribers.
+   */
+  size_t subscribe(std::initializer_list<const char*> field_names, callback on_change) {
+    changes watched;
+    for (const char* name : field_names) {
+      const size_t field = field_index(name);
+      if (field == no_field) { throw std::invalid_argument(std::string("no mapped field named ") + name); }
+      watched.set(field);
+    }
+    return subscribe(watched, std::move(on_change));
+  }
+
+  size_t subscribe(const changes& watched, callback on_change) {
+    size_t id = 0;
+    while (id < MaxSubscribers && callbacks_[id]) { ++id; }
+    if (id == MaxSubscribers) { throw std::length_error("field_observer has no subscriber slot left"); }
+
+    callbacks_[id] = std::move(on_change);
+    subscriptions_[id] = watched;
+    for (size_t f = 0; f < fields; ++f) { field_subscribers_[f][id] = watched[f]; }
+    update_watched();
+    return id;
+  }
+
+  /**
+   * May be called by a callback, for itself or another subscriber : the callback is no longer called from then
+   * on, but is only released, and its slot freed, once decode has run the callbacks.
+   */
+  void unsubscribe(size_t id) {
+    subscriptions_[id].reset();
+    for (auto& s : field_subscribers_) { s.reset(id); }
+    update_watched();
+    if (dispatching_) {
+      released_.set(id);
+    } else {
+      callbacks_[id] = nullptr;
+    }
+  }
+
+  /**
+   * Decodes frame into state and notifies the subscribers of the watched fields which changed.
+   * \return the watched fields which changed.
+   */
+  changes decode(uint32_t device, const Binary& frame, Config& state) {
+    changes changed;
+    if (watched_.empty()) {
+      fill_all(frame, state);
+      return changed;
+    }
+
+    subscribers notified;
+    for (size_t field : watched_) {
+      if (!same_table[field](frame, state)) {
+        changed.set(field);
+        notified |= field_subscribers_[field];
+      }
+    }
+    fill_all(frame, state);
+
+    const dispatch guard{ *this };
+    for (size_t id = 0; notified.any() && id < MaxSubscribers; ++id) {
+      if (notified[id]) {
+        notified.reset(id);
+        if (!released_[id]) {
+          callbacks_[id](device, static_cast<const Config&>(state), changed & subscriptions_[id]);
+        }
+      }
+    }
+    return changed;
+  }
+
+  /**
+   * Fields with at least one subscriber.
+   */
+  const std::vector<size_t>& watched() const { return watched_; }
+
+private:
+
+  using same_fn = bool (*)(const Binary&, const Config&);
+
+  // The field of the frame against the state, before it is filled : no copy of the state is needed.
+  // Fields without a name cannot be subscribed to.
+  template <size_t I>
+  static bool same_one(const Binary& frame, const Config& state) {
+    if constexpr (dest_name_of<mapping, I>(0) != nullptr) {
+      return mapping::decode_value(std::integral_constant<size_t, I>{}, frame) ==
+             mapping::dest_value(std::integral_constant<size_t, I>{}, state);
+    } else {
+      return true;
+    }
+  }
+
+  template <size_t... I>
+  static constexpr std::array<same_fn, fields> make_same_table(std::index_sequence<I...>) {
+    return {{ &same_one<I>... }};
+  }
+
+  static constexpr std::array<same_fn, fields> same_table = make_same_table(mappings{});
+
+  template <size_t... I>
+  static const std::array<const char*, fields>& names(std::index_sequence<I...>) {
+    static constexpr std::array<const char*, fields> table{{ dest_name_of<mapping, I>(0)... }};
+    return table;
+  }
+
+  static const std::array<const char*, fields>& names() { return names(mappings{}); }
+
+  // Callbacks unsubscribed while decode runs them are released after the last one returned, or threw.
+  struct dispatch {
+    field_observer& observer;
+
+    explicit dispatch(field_observer& o) : observer(o) { ++observer.dispatching_; }
+
+    ~dispatch() {
+      if (--observer.dispatching_ == 0 && observer.released_.any()) {
+        for (size_t id = 0; id < MaxSubscribers; ++id) {
+          if (observer.released_[id]) { observer.callbacks_[id] = nullptr; }
+        }
+        observer.released_.reset();
+      }
+    }
+  };
+
+  void update_watched() {
+    watched_.clear();
+    for (size_t f = 0; f < fields; ++f) {
+      if (field_subscribers_[f].any()) { watched_.push_back(f); }
+    }
+  }
+
+  std::array<callback, MaxSubscribers> callbacks_;
+  std::array<changes, MaxSubscribers> subscriptions_;
+  std::array<subscribers, fields> field_subscribers_;
+  std::vector<size_t> watched_;
+  size_t dispatching_ = 0;
+  subscribers released_;
+};
+
+template <class Binary, class Config, size_t MaxSubscribers>
+constexpr std::array<typename field_observer<Binary, Config, MaxSubscribers>::same_fn,
+                     field_observer<Binary, Config, MaxSubscribers>::fields>
+field_observer<Binary, Config, MaxSubscribers>::same_table;
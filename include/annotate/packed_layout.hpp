@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <type_traits>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/seq.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/seq/enum.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
+#include <boost/preprocessor/tuple/size.hpp>
+
+#include "./wire_cast.hpp"
+#include "./member_mapping.hpp"
+
+/*
+ * Packed layouts
+ *
+ * Rationale : For internal formats, where we control both ends, nobody needs to lay the frame out by hand. The
+ *             mapped model fields and their widths are enough to compute, at compile time, the smallest layout :
+ *             whole byte fields come first, by decreasing alignment so that each falls on its natural alignment
+ *             without padding and can be read with a single load, then every other field is packed bit after
+ *             bit, bools grouped in bytes.
+ *
+ *             packed_layout() declares the frame, a byte array of the computed size, and its member_mapping :
+ *             fill_all, update_all and everything built on member_mapping work on it like on a hand written
+ *             binary representation. Fields are little endian on the wire, signed integrals and enums of a
+ *             signed type in two's complement on their width, sign extended when read. The others, durations
+ *             included, are unsigned.
+ */
+
+/**
+ * Wire width of a model field when packed_layout() is not given one.
+ */
+template <class T, class Enable = void>
+struct default_wire_bits {
+  static_assert(sizeof(T) == 0, "no default wire width for this model type, give it in packed_layout()");
+};
+
+template <>
+struct default_wire_bits<bool> : std::integral_constant<size_t, 1> {};
+
+template <class T>
+struct default_wire_bits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+  : std::integral_constant<size_t, sizeof(T) * 8> {};
+
+template <class T>
+struct default_wire_bits<T, std::enable_if_t<std::is_enum<T>::value>>
+  : std::integral_constant<size_t, sizeof(T) * 8> {};
+
+/**
+ * Bit offset of each field and size of the frame.
+ */
+template <size_t N>
+struct packed_plan {
+  std::array<size_t, N> offsets{};
+  size_t bytes = 0;
+};
+
+template <size_t N>
+constexpr packed_plan<N> make_packed_plan(const std::array<size_t, N>& widths) {
+  auto whole_bytes = [&](size_t i) { return widths[i] % 8 == 0; };
+
+  // Natural alignment of a whole byte field, up to 8 bytes.
+  auto alignment = [&](size_t i) {
+    size_t bytes = 1;
+    while (bytes < 8 && (widths[i] / 8) % (bytes * 2) == 0) { bytes *= 2; }
+    return whole_bytes(i) ? bytes : 0;
+  };
+
+  // Placement order : whole byte fields by decreasing alignment, so that none needs padding, then the others.
+  // Widest first, then declaration order.
+  std::array<size_t, N> order{};
+  for (size_t i = 0; i < N; ++i) { order[i] = i; }
+  for (size_t i = 1; i < N; ++i) {
+    const size_t field = order[i];
+    size_t j = i;
+    for (; j > 0; --j) {
+      const size_t before = order[j - 1];
+      const bool goes_first = alignment(field) > alignment(before) ||
+        (alignment(field) == alignment(before) && widths[field] > widths[before]);
+      if (!goes_first) { break; }
+      order[j] = before;
+    }
+    order[j] = field;
+  }
+
+  packed_plan<N> plan;
+  size_t bit = 0;
+  for (size_t k = 0; k < N; ++k) {
+    plan.offsets[order[k]] = bit;
+    bit += widths[order[k]];
+  }
+  plan.bytes = (bit + 7) / 8;
+  return plan;
+}
+
+/**
+ * Reads and writes the Width bits at Offset : whole byte fields with one load of their bytes, the others with
+ * one load of the few bytes they span.
+ */
+template <size_t Offset, size_t Width, size_t Size>
+inline uint64_t packed_read(const std::array<uint8_t, Size>& bytes) {
+  constexpr size_t first = Offset / 8;
+  constexpr size_t shift = Offset % 8;
+  constexpr size_t span = (shift + Width + 7) / 8;
+  static_assert(span <= 8, "a packed field spans at most 8 bytes");
+  constexpr uint64_t mask = (Width == 64) ? ~uint64_t{0} : ((uint64_t{1} << (Width % 64)) - 1);
+
+  uint64_t word = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::memcpy(&word, bytes.data() + first, span);
+#else
+  for (size_t i = 0; i < span; ++i) { word |= uint64_t{bytes[first + i]} << (8 * i); }
+#endif
+  return (word >> shift) & mask;
+}
+
+template <size_t Offset, size_t Width, size_t Size>
+inline void packed_write(std::array<uint8_t, Size>& bytes, uint64_t value) {
+  constexpr size_t first = Offset / 8;
+  constexpr size_t shift = Offset % 8;
+  constexpr size_t span = (shift + Width + 7) / 8;
+  static_assert(span <= 8, "a packed field spans at most 8 bytes");
+  constexpr uint64_t mask = (Width == 64) ? ~uint64_t{0} : ((uint64_t{1} << (Width % 64)) - 1);
+
+  uint64_t word = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::memcpy(&word, bytes.data() + first, span);
+  word = (word & ~(mask << shift)) | ((value & mask) << shift);
+  std::memcpy(bytes.data() + first, &word, span);
+#else
+  for (size_t i = 0; i < span; ++i) { word |= uint64_t{bytes[first + i]} << (8 * i); }
+  word = (word & ~(mask << shift)) | ((value & mask) << shift);
+  for (size_t i = 0; i < span; ++i) { bytes[first + i] = static_cast<uint8_t>(word >> (8 * i)); }
+#endif
+}
+
+/**
+ * Model types read back sign extended from their wire width.
+ */
+template <class T, class Enable = void>
+struct packed_signed : std::integral_constant<bool, std::is_integral<T>::value && std::is_signed<T>::value> {};
+
+template <class T>
+struct packed_signed<T, std::enable_if_t<std::is_enum<T>::value>> : packed_signed<std::underlying_type_t<T>> {};
+
+template <class T, size_t Width>
+constexpr uint64_t packed_extend(uint64_t bits) {
+  if constexpr (packed_signed<T>::value && Width < 64) {
+    constexpr uint64_t sign = uint64_t{ 1 } << (Width - 1);
+    return (bits ^ sign) - sign;
+  } else {
+    return bits;
+  }
+}
+
+/**
+ * ((destpath)) packs a field on its default width, ((destpath, width)) on the given width.
+ */
+#define PACKED_FIELD_PATH(elem) BOOST_PP_TUPLE_ELEM(BOOST_PP_TUPLE_SIZE(elem), 0, elem)
+
+#define PACKED_FIELD_WIDTH(elem) BOOST_PP_CAT(PACKED_FIELD_WIDTH_, BOOST_PP_TUPLE_SIZE(elem))(elem)
+#define PACKED_FIELD_WIDTH_1(elem) \
+  default_wire_bits<std::decay_t<decltype(std::declval<dest_type&>(). BOOST_PP_TUPLE_ELEM(1, 0, elem))>>::value
+#define PACKED_FIELD_WIDTH_2(elem) BOOST_PP_TUPLE_ELEM(2, 1, elem)
+
+#define PACKED_FIELDS_WIDTHS_ON_EACH(r, data, elem) (PACKED_FIELD_WIDTH(elem))
+
+#define member_map_packed(id, destpath)                                                                        \
+  static void fill(std::integral_constant<size_t, id>, const src_type& s, dest_type& d) {                      \
+    d. destpath = wire_cast<decltype(d. destpath)>(packed_extend<decltype(d. destpath), src_type::widths[id]>( \
+      packed_read<src_type::plan.offsets[id], src_type::widths[id]>(s.bytes)));                                \
+  }                                                                                                            \
+  static void update(std::integral_constant<size_t, id>, src_type& s, const dest_type& d) {                    \
+    packed_write<src_type::plan.offsets[id], src_type::widths[id]>(s.bytes, wire_cast<uint64_t>(d. destpath)); \
+  }                                                                                                            \
+  static std::decay_t<decltype(std::declval<dest_type&>(). destpath)>                                          \
+  decode_value(std::integral_constant<size_t, id>, const src_type& s) {                                        \
+    using value_type = std::decay_t<decltype(std::declval<dest_type&>(). destpath)>;                           \
+    return wire_cast<value_type>(packed_extend<value_type, src_type::widths[id]>(                              \
+      packed_read<src_type::plan.offsets[id], src_type::widths[id]>(s.bytes)));                                \
+  }                                                                                                            \
+  static void encode_value(std::integral_constant<size_t, id>, src_type& s,                                    \
+                           const std::decay_t<decltype(std::declval<dest_type&>(). destpath)>& v) {            \
+    packed_write<src_type::plan.offsets[id], src_type::widths[id]>(s.bytes, wire_cast<uint64_t>(v));           \
+  }                                                                                                            \
+  static decltype(std::declval<dest_type>(). destpath)                                                         \
+  dest_value(std::integral_constant<size_t, id>, const dest_type& d) {                                         \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static auto& dest_field(std::integral_constant<size_t, id>, dest_type& d) {                                  \
+    return d. destpath;                                                                                        \
+  }                                                                                                            \
+  static constexpr const char* dest_name(std::integral_constant<size_t, id>) {                                 \
+    return BOOST_PP_STRINGIZE(destpath);                                                                       \
+  }                                                                                                            \
+  static void mark_source(std::integral_constant<size_t, id>, int, src_type& s) {                              \
+    packed_write<src_type::plan.offsets[id], src_type::widths[id]>(s.bytes, ~uint64_t{ 0 });                   \
+  }                                                                                                            \
+  MEMBER_MAP_DEST_SPAN(id, destpath)
+
+#define PACKED_MAPPINGS_ON_EACH(r, data, i, elem) member_map_packed(i, PACKED_FIELD_PATH(elem))
+
+#define packed_layout(NAME, DEST_TYPE, FIELDS)                                                                  \
+  struct NAME {                                                                                                \
+    typedef DEST_TYPE dest_type;                                                                               \
+                                                                                                               \
+    static constexpr std::array<size_t, BOOST_PP_SEQ_SIZE(FIELDS)> widths{{                                   \
+      BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_FOR_EACH(PACKED_FIELDS_WIDTHS_ON_EACH, _, FIELDS))                       \
+    }};                                                                                                        \
+    static constexpr packed_plan<BOOST_PP_SEQ_SIZE(FIELDS)> plan = make_packed_plan(widths);                  \
+    static constexpr size_t size = plan.bytes;                                                                 \
+                                                                                                               \
+    std::array<uint8_t, size> bytes;                                                                           \
+  };                                                                                                           \
+                                                                                                               \
+  template<>                                                                                                   \
+  struct member_mapping<NAME, DEST_TYPE> : public std::true_type {                                             \
+                                                                                                               \
+    typedef NAME src_type;                                                                                     \
+    typedef DEST_TYPE dest_type;                                                                               \
+                                                                                                               \
+    typedef std::make_index_sequence<BOOST_PP_SEQ_SIZE(FIELDS)> mappings;                                      \
+                                                                                                               \
+    BOOST_PP_SEQ_FOR_EACH_I(PACKED_MAPPINGS_ON_EACH, _, FIELDS)                                                \
+  };
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <typeinfo>
+#include <utility>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <link.h>
+#include <unistd.h>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Profile map
+ *
+ * Rationale : A sampling profiler shows the codec of a mapping as member_mapping<...>::fill(integral_constant<...>)
+ *             at best, or charges everything to the caller once it is inlined : hot spots cannot be traced back
+ *             to fields. Built with -DANNOTATE_PROFILE, the entry points of member_mapping.hpp are functions of
+ *             their own : fill_all and update_all per struct, fill_run and update_run per run of the copy plan,
+ *             fill_field and update_field per field converted on its own.
+ *
+ *             codec_symbols lists them for a mapping, with the fields each one handles and its code range, taken
+ *             from the dynamic symbol table : the program is linked with -rdynamic (ENABLE_EXPORTS), otherwise
+ *             the ranges are empty. write_perf_map writes them in the /tmp/perf-<pid>.map format, one
+ *             "start size name" line each, write_symbol_json as a JSON array. perf itself only reads the map for
+ *             code it finds no symbol for, the map is there to join the samples of perf script, or of any
+ *             profiler giving addresses, back to the fields.
+ */
+
+/**
+ * One entry point : its code range, its symbol as the profiler shows it, and the model fields it handles, with
+ * their binary fields when the mapping names them.
+ */
+struct codec_symbol {
+  uintptr_t start = 0;
+  size_t size = 0;
+  std::string symbol;
+  std::string codec;
+  std::string entry;
+  std::vector<std::string> fields;
+  std::vector<std::string> sources;
+
+  /**
+   * codec::entry fields, the name of the range in a perf map.
+   */
+  std::string name() const {
+    std::string n = codec + "::" + entry;
+    for (size_t i = 0; i < fields.size(); ++i) { n += (i ? "," : " ") + fields[i]; }
+    return n;
+  }
+};
+
+inline std::string demangled(const char* mangled) {
+  int status = 0;
+  std::unique_ptr<char, void (*)(void*)> name(abi::__cxa_demangle(mangled, nullptr, nullptr, &status), std::free);
+  return (status == 0 && name) ? std::string(name.get()) : std::string(mangled);
+}
+
+/**
+ * Fills start, and size and symbol when the dynamic symbol table has the function.
+ */
+inline void locate(codec_symbol& s, const void* address) {
+  s.start = reinterpret_cast<uintptr_t>(address);
+  Dl_info info{};
+  void* entry = nullptr;
+  if (dladdr1(address, &info, &entry, RTLD_DL_SYMENT) && entry && info.dli_saddr == address && info.dli_sname) {
+    s.size = static_cast<const ElfW(Sym)*>(entry)->st_size;
+    s.symbol = demangled(info.dli_sname);
+  }
+}
+
+template <class SRC, class DEST>
+class codec_symbol_table {
+public:
+
+  using mapping = member_mapping<SRC, DEST>;
+  using mappings = typename mapping::mappings;
+  using plan = copy_plan<SRC, DEST>;
+
+  static std::vector<codec_symbol> symbols() {
+    std::vector<codec_symbol> table;
+    const std::string codec = demangled(typeid(SRC).name());
+
+    std::vector<size_t> all;
+    for (size_t i = 0; i < mappings::size(); ++i) { all.push_back(i); }
+    add(table, codec, "fill_all", all, static_cast<void (*)(const SRC&, DEST&)>(&fill_all<SRC, DEST>));
+    add(table, codec, "update_all", all, static_cast<void (*)(SRC&, const DEST&)>(&update_all<SRC, DEST>));
+
+    add_runs(table, codec, typename plan::run_indices{});
+    add_fields(table, codec, mappings{});
+    return table;
+  }
+
+private:
+
+  template <size_t... I>
+  static std::string field_name(size_t i, std::index_sequence<I...>) {
+    const char* names[] = { dest_name_of<mapping, I>(0)... };
+    return names[i] ? std::string(names[i]) : "column " + std::to_string(i);
+  }
+
+  static std::string field_name(size_t i) { return field_name(i, mappings{}); }
+
+  template <size_t... I>
+  static std::string source_name(size_t i, std::index_sequence<I...>) {
+    const char* names[] = { src_name_of<mapping, I>(0)... };
+    return names[i] ? std::string(names[i]) : std::string();
+  }
+
+  static std::string source_name(size_t i) { return source_name(i, mappings{}); }
+
+  template <class Function>
+  static void add(std::vector<codec_symbol>& table, const std::string& codec, const char* entry,
+                  const std::vector<size_t>& fields, Function* function) {
+    codec_symbol s;
+    locate(s, reinterpret_cast<const void*>(function));
+    s.codec = codec;
+    s.entry = entry;
+    for (size_t i : fields) {
+      s.fields.push_back(field_name(i));
+      const std::string source = source_name(i);
+      if (!source.empty()) { s.sources.push_back(source); }
+    }
+    if (s.symbol.empty()) { s.symbol = s.name(); }
+    table.push_back(std::move(s));
+  }
+
+  // The fields of a run are those whose bytes it copies.
+  template <size_t... R>
+  static void add_runs(std::vector<codec_symbol>& table, const std::string& codec, std::index_sequence<R...>) {
+    (add_run<R>(table, codec), ...);
+  }
+
+  template <size_t R>
+  static void add_run(std::vector<codec_symbol>& table, const std::string& codec) {
+    constexpr auto& run = plan::runs.runs[R];
+    std::vector<size_t> fields;
+    for (size_t i = 0; i < mappings::size(); ++i) {
+      const copy_span& span = plan::spans[i];
+      if (span.kind != copy_kind::transform && span.src >= run.src && span.src < run.src + run.size) {
+        fields.push_back(i);
+      }
+    }
+    add(table, codec, "fill_run", fields, &fill_run<SRC, DEST, R>);
+    add(table, codec, "update_run", fields, &update_run<SRC, DEST, R>);
+  }
+
+  template <size_t... I>
+  static void add_fields(std::vector<codec_symbol>& table, const std::string& codec, std::index_sequence<I...>) {
+    (add_field<I>(table, codec), ...);
+  }
+
+  template <size_t I>
+  static void add_field(std::vector<codec_symbol>& table, const std::string& codec) {
+    if constexpr (plan::spans[I].kind == copy_kind::transform) {
+      const std::vector<size_t> fields{ I };
+      add(table, codec, "fill_field", fields, &fill_field<SRC, DEST, I>);
+      add(table, codec, "update_field", fields, &update_field<SRC, DEST, I>);
+    }
+  }
+};
+
+/**
+ * The entry points of the codec of SRC into DEST. Meaningful with -DANNOTATE_PROFILE : otherwise the entry points
+ * are inlined where they are called, and the listed ones are copies which never run.
+ */
+template <class SRC, class DEST>
+std::vector<codec_symbol> codec_symbols() {
+  return codec_symbol_table<SRC, DEST>::symbols();
+}
+
+/**
+ * The entry point whose code holds address, e.g. a sample of perf script, or nullptr.
+ */
+inline const codec_symbol* symbol_at(const std::vector<codec_symbol>& symbols, uintptr_t address) {
+  for (const auto& s : symbols) {
+    if (address >= s.start && address < s.start + s.size) { return &s; }
+  }
+  return nullptr;
+}
+
+inline std::string perf_map_path() { return "/tmp/perf-" + std::to_string(::getpid()) + ".map"; }
+
+inline void write_perf_map(std::ostream& out, const std::vector<codec_symbol>& symbols) {
+  const auto flags = out.flags();
+  for (const auto& s : symbols) {
+    out << std::hex << s.start << ' ' << s.size << std::dec << ' ' << s.name() << '\n';
+  }
+  out.flags(flags);
+}
+
+inline std::string json_quoted(const std::string& text) {
+  std::string quoted = "\"";
+  for (char c : text) {
+    if (c == '"' || c == '\\') { quoted += '\\'; }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+inline void write_symbol_json(std::ostream& out, const std::vector<codec_symbol>& symbols) {
+  out << "[\n";
+  for (size_t i = 0; i < symbols.size(); ++i) {
+    const codec_symbol& s = symbols[i];
+    out << "  { \"start\": " << s.start << ", \"size\": " << s.size
+        << ", \"symbol\": " << json_quoted(s.symbol) << ", \"codec\": " << json_quoted(s.codec)
+        << ", \"entry\": " << json_quoted(s.entry) << ", \"fields\": [";
+    for (size_t f = 0; f < s.fields.size(); ++f) { out << (f ? ", " : "") << json_quoted(s.fields[f]); }
+    out << "], \"sources\": [";
+    for (size_t f = 0; f < s.sources.size(); ++f) { out << (f ? ", " : "") << json_quoted(s.sources[f]); }
+    out << "] }" << (i + 1 < symbols.size() ? "," : "") << '\n';
+  }
+  out << "]\n";
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+/*
+ * Replay
+ *
+ * Rationale : replay feeds the records of a frame log (frame_log.hpp) to the pipeline under test, e.g. the decode,
+ *             diff and notify of a field_observer, in the order they were recorded. At max speed each record
+ *             follows the previous one at once, and its latency is the time its processing took. At recorded
+ *             speed each record is due at its recorded time from the start of the replay : its latency runs
+ *             from that time, so that the time spent behind schedule after a slow record counts, as it would
+ *             on the link.
+ *
+ *             One clock read per record : the end of a record is the start of the next one at max speed.
+ *             Latencies go to a latency_histogram, log-linear like HdrHistogram : exact below 32 ns, then 16
+ *             buckets per power of two, a percentile is off by 6.25% at most. Recording is an increment.
+ */
+class latency_histogram {
+public:
+
+  static constexpr size_t sub_buckets = 16;
+  static constexpr size_t exact = 2 * sub_buckets;
+  static constexpr size_t buckets = exact + (64 - 5) * sub_buckets;
+
+  void record(uint64_t ns) {
+    ++counts_[bucket_of(ns)];
+    ++count_;
+    sum_ += ns;
+    max_ = std::max(max_, ns);
+  }
+
+  void merge(const latency_histogram& other) {
+    for (size_t b = 0; b < buckets; ++b) { counts_[b] += other.counts_[b]; }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  uint64_t count() const { return count_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0; }
+
+  /**
+   * \return the latency percent of the records did not exceed, as the upper bound of its bucket.
+   */
+  uint64_t percentile(double percent) const {
+    if (count_ == 0) { return 0; }
+    const double wanted = percent / 100 * count_;
+    uint64_t rank = static_cast<uint64_t>(wanted);
+    rank = std::max<uint64_t>(1, std::min<uint64_t>(count_, rank + (rank < wanted)));
+
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+      seen += counts_[b];
+      if (seen >= rank) { return std::min(upper_bound(b), max_); }
+    }
+    return max_;
+  }
+
+  static size_t bucket_of(uint64_t ns) {
+    if (ns < exact) { return static_cast<size_t>(ns); }
+    const size_t msb = 63 - static_cast<size_t>(__builtin_clzll(ns));
+    const size_t top = static_cast<size_t>(ns >> (msb - 4));
+    return exact + (msb - 5) * sub_buckets + (top - sub_buckets);
+  }
+
+  static uint64_t upper_bound(size_t bucket) {
+    if (bucket < exact) { return bucket; }
+    const size_t msb = (bucket - exact) / sub_buckets + 5;
+    const uint64_t top = (bucket - exact) % sub_buckets + sub_buckets;
+    return ((top + 1) << (msb - 4)) - 1;
+  }
+
+private:
+  std::array<uint64_t, buckets> counts_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+enum class replay_speed { max, recorded };
+
+struct replay_report {
+  size_t records = 0;
+  std::chrono::nanoseconds elapsed{ 0 };
+  latency_histogram latency;
+
+  /**
+   * Records per second.
+   */
+  double throughput() const {
+    return elapsed.count() ? records * 1e9 / static_cast<double>(elapsed.count()) : 0;
+  }
+};
+
+/**
+ * Calls process(record) for each of the count records, which have a timestamp in nanoseconds.
+ */
+template <class Record, class Process>
+replay_report replay(const Record* records, size_t count, replay_speed speed, Process&& process) {
+  using clock = std::chrono::steady_clock;
+  replay_report report;
+  report.records = count;
+
+  const clock::time_point start = clock::now();
+  clock::time_point now = start;
+  for (size_t i = 0; i < count; ++i) {
+    clock::time_point due = now;
+    if (speed == replay_speed::recorded) {
+      due = start + std::chrono::nanoseconds(records[i].timestamp - records[0].timestamp);
+      // Sleep while far ahead, spin the rest : sleeps overshoot by tens of microseconds.
+      if (due - now > std::chrono::microseconds(200)) {
+        std::this_thread::sleep_until(due - std::chrono::microseconds(100));
+        now = clock::now();
+      }
+      while (now < due) { now = clock::now(); }
+    }
+
+    process(records[i]);
+    now = clock::now();
+    report.latency.record(
+      static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count()));
+  }
+  report.elapsed = now - start;
+  return report;
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <atomic>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Shared memory ring
+ *
+ * Rationale : The HMI, the logger and the protocol daemons all need the decoded state. Instead of each of them
+ *             decoding the frames, one writer publishes records in a ring in POSIX shared memory, e.g. the
+ *             flat records of flat_record.hpp. The ring header keeps Record::layout::hash, a reader built
+ *             against another layout refuses the ring instead of misreading it.
+ *
+ *             Each slot of the ring is protected by a seqlock : the writer never waits, a reader retries if the
+ *             slot changed while it was copied.
+ */
+template <class Record>
+class shm_ring {
+public:
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock must work across processes");
+
+  /**
+   * Creates (or resets) the ring, for its single writer.
+   * \throw std::system_error EINVAL for a ring without slot.
+   */
+  static shm_ring create(const std::string& name, uint32_t capacity) {
+    if (capacity == 0) { throw std::system_error(EINVAL, std::generic_category(), name + " needs at least one slot"); }
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) { throw std::system_error(errno, std::generic_category(), "shm_open " + name); }
+
+    const size_t bytes = sizeof(header) + size_t{capacity} * slot_stride;
+    if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "ftruncate " + name);
+    }
+
+    shm_ring ring{fd, bytes};
+    header* h = ring.head();
+    h->layout = Record::layout::hash;
+    h->record_size = static_cast<uint32_t>(sizeof(Record));
+    h->capacity = capacity;
+    h->published.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    reinterpret_cast<std::atomic<uint64_t>*>(&h->magic)->store(magic, std::memory_order_release);
+    return ring;
+  }
+
+  /**
+   * Opens an existing ring for reading, refusing it if it was made for another record layout.
+   */
+  static shm_ring open(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) { throw std::system_error(errno, std::generic_category(), "shm_open " + name); }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(header)) {
+      ::close(fd);
+      throw std::system_error(EINVAL, std::generic_category(), name + " is not a ring");
+    }
+
+    shm_ring ring{fd, size_t(st.st_size)};
+    header* h = ring.head();
+    if (reinterpret_cast<std::atomic<uint64_t>*>(&h->magic)->load(std::memory_order_acquire) != magic ||
+        h->layout != Record::layout::hash || h->record_size != sizeof(Record) || h->capacity == 0 ||
+        sizeof(header) + size_t{h->capacity} * slot_stride > ring.bytes_) {
+      throw std::system_error(EPROTO, std::generic_category(), name + " holds another record layout");
+    }
+    return ring;
+  }
+
+  static void unlink(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+  shm_ring(shm_ring&& other) noexcept : fd_(other.fd_), bytes_(other.bytes_), base_(other.base_) {
+    other.fd_ = -1;
+    other.base_ = nullptr;
+  }
+
+  shm_ring(const shm_ring&) = delete;
+  shm_ring& operator=(const shm_ring&) = delete;
+  shm_ring& operator=(shm_ring&&) = delete;
+
+  ~shm_ring() {
+    if (base_ != nullptr) { ::munmap(base_, bytes_); }
+    if (fd_ >= 0) { ::close(fd_); }
+  }
+
+  /**
+   * Single writer only.
+   */
+  void publish(const Record& record) {
+    header* h = head();
+    const uint64_t n = h->published.load(std::memory_order_relaxed);
+    slot& s = slot_at(n);
+
+    s.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(s.record, &record, sizeof(Record));
+    s.sequence.store(2 * n + 2, std::memory_order_release);
+
+    h->published.store(n + 1, std::memory_order_release);
+  }
+
+  /**
+   * \return how many records were ever published.
+   */
+  uint64_t published() const { return head()->published.load(std::memory_order_acquire); }
+
+  /**
+   * Reads the record published as number n, false if it is not published yet or already overwritten.
+   */
+  bool read(uint64_t n, Record& record) const {
+    const slot& s = slot_at(n);
+    for (;;) {
+      const uint64_t before = s.sequence.load(std::memory_order_acquire);
+      if (before != 2 * n + 2) { return false; }
+
+      std::memcpy(&record, s.record, sizeof(Record));
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (s.sequence.load(std::memory_order_relaxed) == before) { return true; }
+    }
+  }
+
+  bool read_latest(Record& record) const {
+    for (;;) {
+      const uint64_t n = published();
+      if (n == 0) { return false; }
+      if (read(n - 1, record)) { return true; }
+    }
+  }
+
+  uint32_t capacity() const { return head()->capacity; }
+
+private:
+
+  static constexpr uint64_t magic = 0x676E69725F6E6E61ull; // "ann_ring"
+
+  struct header {
+    uint64_t magic;
+    uint32_t layout;
+    uint32_t record_size;
+    uint32_t capacity;
+    alignas(64) std::atomic<uint64_t> published;
+  };
+
+  struct alignas(64) slot {
+    std::atomic<uint64_t> sequence;
+    unsigned char record[sizeof(Record)];
+  };
+
+  static constexpr size_t slot_stride = sizeof(slot);
+
+  shm_ring(int fd, size_t bytes) : fd_(fd), bytes_(bytes) {
+    base_ = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base_ == MAP_FAILED) {
+      const int err = errno;
+      base_ = nullptr;
+      ::close(fd_);
+      throw std::system_error(err, std::generic_category(), "mmap");
+    }
+  }
+
+  header* head() const { return static_cast<header*>(base_); }
+
+  slot& slot_at(uint64_t n) const {
+    return reinterpret_cast<slot*>(static_cast<char*>(base_) + sizeof(header))[n % head()->capacity];
+  }
+
+  int fd_ = -1;
+  size_t bytes_ = 0;
+  void* base_ = nullptr;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Stream parser
+ *
+ * Rationale : Serial links deliver frames in chunks of any size, and waiting for a whole frame before decoding
+ *             anything adds the time the rest of the frame takes to arrive. stream_parser is a resumable state
+ *             machine over a stream of back to back frames : its state is the byte count of the current frame
+ *             and the next field of its schedule. Each chunk is appended to the frame being received and every
+ *             field whose last byte has arrived is decoded at once, through a jump table of the fill of each
+ *             member_map. Frames lying whole in a chunk go through fill_all and its copy plan.
+ *
+ *             Fields are scheduled by the last byte of their binary field : a field waits for all its bytes,
+ *             whatever part of them its conversion keeps. Bit positions of bitfields are not constant
+ *             expressions, so the schedule is computed once per mapping, on first use, from the bits mark_source
+ *             sets in a frame of zeros. Mappings which do not locate their binary field wait for the whole frame.
+ */
+template <class Binary, class Config>
+class stream_parser {
+public:
+
+  using mapping = member_mapping<Binary, Config>;
+  using mappings = typename mapping::mappings;
+  static constexpr size_t fields = mappings::size();
+  static constexpr size_t frame_size = sizeof(Binary);
+
+  /**
+   * Fields in decoding order, and the bytes of the frame each one needs.
+   */
+  struct schedule_type {
+    std::array<size_t, fields> order;
+    std::array<size_t, fields> needs;
+  };
+
+  stream_parser() : frame_{}, config_{} {}
+
+  /**
+   * Consumes a chunk of the stream, calls on_record(const Config&) for each frame it completes.
+   * \return the number of frames completed.
+   */
+  template <class OnRecord>
+  size_t feed(const uint8_t* data, size_t size, OnRecord&& on_record) {
+    size_t records = 0;
+    auto* frame = reinterpret_cast<uint8_t*>(&frame_);
+
+    while (size) {
+      if (received_ == 0 && size >= frame_size) {
+        std::memcpy(frame, data, frame_size);
+        fill_all(frame_, config_);
+        data += frame_size;
+        size -= frame_size;
+      } else {
+        const size_t n = std::min(size, frame_size - received_);
+        std::memcpy(frame + received_, data, n);
+        received_ += n;
+        data += n;
+        size -= n;
+
+        const schedule_type& s = schedule();
+        for (; next_ < fields && s.needs[next_] <= received_; ++next_) {
+          fill_table[s.order[next_]](frame_, config_);
+        }
+        if (received_ < frame_size) { break; }
+        reset();
+      }
+
+      on_record(static_cast<const Config&>(config_));
+      ++records;
+    }
+    return records;
+  }
+
+  /**
+   * Bytes of the current frame received so far, and fields of it already decoded. The fields not decoded yet
+   * keep the values of the previous frame.
+   */
+  size_t received() const { return received_; }
+  size_t fields_ready() const { return next_; }
+  const Config& partial() const { return config_; }
+
+  /**
+   * Drops the frame being received, e.g. after a link error.
+   */
+  void reset() {
+    received_ = 0;
+    next_ = 0;
+  }
+
+  static const schedule_type& schedule() {
+    static const schedule_type s = make_schedule(mappings{});
+    return s;
+  }
+
+private:
+  using fill_fn = void (*)(const Binary&, Config&);
+
+  template <size_t I>
+  static void fill_one(const Binary& frame, Config& config) {
+    mapping::fill(std::integral_constant<size_t, I>{}, frame, config);
+  }
+
+  template <size_t... I>
+  static constexpr std::array<fill_fn, fields> make_fill_table(std::index_sequence<I...>) {
+    return {{ &fill_one<I>... }};
+  }
+
+  static constexpr std::array<fill_fn, fields> fill_table = make_fill_table(mappings{});
+
+  template <size_t I>
+  static size_t last_byte() {
+    Binary mask;
+    std::memset(&mask, 0, frame_size);
+    mark_source_of<mapping, I>(mask, 0);
+
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&mask);
+    for (size_t byte = frame_size; byte > 0; --byte) {
+      if (bytes[byte - 1]) { return byte; }
+    }
+    return 0;
+  }
+
+  template <size_t... I>
+  static schedule_type make_schedule(std::index_sequence<I...>) {
+    schedule_type s;
+    const std::array<size_t, fields> needs{{ last_byte<I>()... }};
+    for (size_t i = 0; i < fields; ++i) { s.order[i] = i; }
+    std::stable_sort(s.order.begin(), s.order.end(), [&](size_t a, size_t b) { return needs[a] < needs[b]; });
+    for (size_t i = 0; i < fields; ++i) { s.needs[i] = needs[s.order[i]]; }
+    return s;
+  }
+
+  Binary frame_;
+  Config config_;
+  size_t received_ = 0;
+  size_t next_ = 0;
+};
+
+template <class Binary, class Config>
+constexpr std::array<typename stream_parser<Binary, Config>::fill_fn, stream_parser<Binary, Config>::fields>
+stream_parser<Binary, Config>::fill_table;
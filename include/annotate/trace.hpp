@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <type_traits>
+#include <boost/mpl/size.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/string.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "./annotations.hpp"
+
+/*
+ * Hot path instrumentation
+ *
+ * Rationale : A field annotated with trace{} counts its conversions, the bytes of model it produced or consumed and
+ *             the cycles spent (rdtsc). The struct itself accumulates in slot 0 of its counters, where the
+ *             annotated list has its bool placeholder. Counters live in a buffer per thread and per struct, only
+ *             written by their thread, so an increment is a plain load and store. Buffers are chained in a
+ *             push-only list and never freed : any thread can read them at any time without a lock.
+ *
+ *             Without -DANNOTATE_TRACE the trace{} tag is ignored and no counting code is generated at all.
+ */
+struct trace {};
+
+#ifdef ANNOTATE_TRACE
+constexpr bool trace_enabled = true;
+#else
+constexpr bool trace_enabled = false;
+#endif
+
+inline uint64_t trace_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+struct trace_counters {
+  std::atomic<uint64_t> conversions{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> cycles{0};
+
+  void add(uint64_t n_bytes, uint64_t n_cycles) {
+    increment(conversions, 1);
+    increment(bytes, n_bytes);
+    increment(cycles, n_cycles);
+  }
+
+private:
+  // Single writer : no need for a locked read-modify-write.
+  static void increment(std::atomic<uint64_t>& counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+};
+
+template <class T>
+struct trace_buffer {
+  static constexpr size_t slots = boost::mpl::size<typename T::annotated>::value;
+
+  std::array<trace_counters, slots> counters;
+  trace_buffer* next = nullptr;
+
+  static std::atomic<trace_buffer*>& head() {
+    static std::atomic<trace_buffer*> list{nullptr};
+    return list;
+  }
+
+  static trace_buffer& local() {
+    static thread_local trace_buffer* buffer = []() {
+      auto* created = new trace_buffer{};
+      created->next = head().load(std::memory_order_relaxed);
+      while (!head().compare_exchange_weak(created->next, created, std::memory_order_release)) {}
+      return created;
+    }();
+    return *buffer;
+  }
+};
+
+struct trace_sample {
+  std::string field;
+  uint64_t conversions;
+  uint64_t bytes;
+  uint64_t cycles;
+};
+
+/**
+ * Sums the counters of all threads. Slot 0 is reported as the struct itself.
+ */
+template <class T>
+std::vector<trace_sample> trace_report(const std::string& struct_name) {
+  std::vector<trace_sample> report;
+  report.push_back({struct_name, 0, 0, 0});
+  boost::mpl::for_each<typename T::annotated>([&](auto name) {
+    if constexpr (!std::is_same<decltype(name), bool>::value) {
+      report.push_back({struct_name + "." + boost::mpl::c_str<decltype(name)>::value, 0, 0, 0});
+    }
+  });
+
+  for (auto* b = trace_buffer<T>::head().load(std::memory_order_acquire); b != nullptr; b = b->next) {
+    for (size_t slot = 0; slot < report.size(); ++slot) {
+      report[slot].conversions += b->counters[slot].conversions.load(std::memory_order_relaxed);
+      report[slot].bytes += b->counters[slot].bytes.load(std::memory_order_relaxed);
+      report[slot].cycles += b->counters[slot].cycles.load(std::memory_order_relaxed);
+    }
+  }
+  return report;
+}
+
+
+template <class Annotations, size_t... I>
+constexpr bool has_trace(std::index_sequence<I...>) {
+  return (std::is_same<std::tuple_element_t<I, Annotations>, trace>::value || ...);
+}
+
+template <class Annotations>
+constexpr bool has_trace() {
+  return has_trace<Annotations>(std::make_index_sequence<std::tuple_size<Annotations>::value>{});
+}
+
+/**
+ * Calls op on every annotation_map of every annotated field, counting the fields annotated with trace{}.
+ */
+template <class T, class Op>
+inline void for_each_mapping(T& bin, Op&& op) {
+  size_t slot = 0;
+  boost::mpl::for_each<typename T::annotated>([&](auto name) {
+    if constexpr (!std::is_same<decltype(name), bool>::value) {
+      ++slot;
+      auto annotations = bin.get_annotations(name);
+      using annotations_t = decltype(annotations);
+
+      auto apply = [&]() {
+        size_t bytes = 0;
+        std::apply([&](auto&... annotation) {
+          ((is_annotation_map<std::decay_t<decltype(annotation)>>::value ? void(bytes += op(annotation)) : void()), ...);
+        }, annotations);
+        return bytes;
+      };
+
+      if constexpr (trace_enabled && has_trace<annotations_t>()) {
+        const uint64_t begin = trace_cycles();
+        const size_t bytes = apply();
+        trace_buffer<T>::local().counters[slot].add(bytes, trace_cycles() - begin);
+      } else {
+        apply();
+      }
+    }
+  });
+}
+
+template <class T, class Config>
+inline void encode(T& bin, const Config& cfg) {
+  const uint64_t begin = trace_enabled ? trace_cycles() : 0;
+
+  for_each_mapping(bin, [&](auto& mapping) {
+    if constexpr (is_annotation_map<std::decay_t<decltype(mapping)>>::value) {
+      mapping.fill_src(bin, cfg);
+      return mapping.bytes;
+    } else {
+      return size_t{0};
+    }
+  });
+
+  if constexpr (trace_enabled) {
+    trace_buffer<T>::local().counters[0].add(sizeof(T), trace_cycles() - begin);
+  }
+}
+
+template <class T, class Config>
+inline void decode(T& bin, Config& cfg) {
+  const uint64_t begin = trace_enabled ? trace_cycles() : 0;
+
+  for_each_mapping(bin, [&](auto& mapping) {
+    if constexpr (is_annotation_map<std::decay_t<decltype(mapping)>>::value) {
+      mapping.fill_dst(bin, cfg);
+      return mapping.bytes;
+    } else {
+      return size_t{0};
+    }
+  });
+
+  if constexpr (trace_enabled) {
+    trace_buffer<T>::local().counters[0].add(sizeof(T), trace_cycles() - begin);
+  }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Translation between two binary representations of the same model
+ *
+ * Rationale : Converting a frame of one device generation to the next through the model decodes every field
+ *             into a model object, then encodes every field out of it. Both mappings name their model fields
+ *             (dest_name), so the fields they share are paired at compile time, and each pair goes straight
+ *             from one frame to the other : decode_value of the source mapping, encode_value of the target
+ *             one, the model value lives in a register. No model object is built. member_map_each columns are
+ *             paired by their column_name the same way, and go through decode_column and encode_column.
+ *
+ *             Each translation starts from a frame of defaults, encoded once from a default model : fields of
+ *             the target that the source does not carry get their default value, as they would through the
+ *             model, and reserved bits are zero whatever the target buffer held, even when every field matches.
+ */
+template <class From, class To, class Config>
+class translator {
+public:
+
+  using from_mapping = member_mapping<From, Config>;
+  using to_mapping = member_mapping<To, Config>;
+  static constexpr size_t from_fields = from_mapping::mappings::size();
+  static constexpr size_t to_fields = to_mapping::mappings::size();
+  static constexpr size_t no_field = static_cast<size_t>(-1);
+
+private:
+
+  static constexpr bool same_name(const char* a, const char* b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    return *a == *b;
+  }
+
+  // A field only pairs with a field, a column with a column.
+  template <size_t... I>
+  static constexpr size_t source_of(const char* name, const char* column, std::index_sequence<I...>) {
+    const char* names[] = { dest_name_of<from_mapping, I>(0)... };
+    const char* columns[] = { column_name_of<from_mapping, I>(0)... };
+    for (size_t i = 0; i < sizeof...(I); ++i) {
+      if (name && names[i] && same_name(names[i], name)) { return i; }
+      if (column && columns[i] && same_name(columns[i], column)) { return i; }
+    }
+    return no_field;
+  }
+
+  template <size_t... J>
+  static constexpr std::array<size_t, to_fields> match(std::index_sequence<J...>) {
+    return {{ source_of(dest_name_of<to_mapping, J>(0), column_name_of<to_mapping, J>(0),
+                        typename from_mapping::mappings{})... }};
+  }
+
+public:
+
+  /**
+   * The source field of each target field, or no_field.
+   */
+  static constexpr std::array<size_t, to_fields> sources = match(typename to_mapping::mappings{});
+
+  static constexpr size_t matched = [] {
+    size_t count = 0;
+    for (size_t source : sources) { count += (source != no_field); }
+    return count;
+  }();
+
+  static void translate(const From& from, To& to) {
+    to = defaults();
+    translate(from, to, typename to_mapping::mappings{});
+  }
+
+  static void translate(const From* from, To* to, size_t count) {
+    for (size_t i = 0; i < count; ++i) { translate(from[i], to[i]); }
+  }
+
+private:
+
+  template <size_t J>
+  static void translate_one(const From& from, To& to) {
+    constexpr size_t I = sources[J];
+    if constexpr (I == no_field) {
+      return;
+    } else if constexpr (column_name_of<to_mapping, J>(0) != nullptr) {
+      to_mapping::encode_column(std::integral_constant<size_t, J>{}, to,
+                                from_mapping::decode_column(std::integral_constant<size_t, I>{}, from));
+    } else {
+      to_mapping::encode_value(std::integral_constant<size_t, J>{}, to,
+                               from_mapping::decode_value(std::integral_constant<size_t, I>{}, from));
+    }
+  }
+
+  template <size_t... J>
+  static void translate(const From& from, To& to, std::index_sequence<J...>) {
+    (translate_one<J>(from, to), ...);
+  }
+
+  static const To& defaults() {
+    static const To frame = [] {
+      To t{};
+      update_all(t, Config{});
+      return t;
+    }();
+    return frame;
+  }
+};
+
+template <class From, class To, class Config>
+constexpr std::array<size_t, translator<From, To, Config>::to_fields> translator<From, To, Config>::sources;
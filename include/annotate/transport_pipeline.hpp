@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Transport pipeline
+ *
+ * Rationale : Encoding and writing are two stages running in parallel. submit() encodes a batch of config
+ *             updates through the member_mapping into one of the pooled batch buffers and hands it over to the
+ *             writer thread, which sends the whole batch with writev(). While batch N is on the wire, batch N+1
+ *             is encoded in another pooled buffer. Nothing is allocated once the pool is warm.
+ *
+ *             On the wire each frame is prefixed by the device address : [address][frame][address][frame]...
+ *             The address and the frame are two iovecs, so the frames are never copied once encoded.
+ */
+template <class Config>
+struct config_update {
+  uint8_t address;
+  Config config;
+};
+
+template <class Binary, class Config>
+class frame_pipeline {
+public:
+
+  /**
+   * \throw std::invalid_argument for batches without room for a frame, or no batch at all.
+   */
+  frame_pipeline(int fd, size_t max_batch_size, size_t pooled_batches = 2)
+    : fd_(fd), max_batch_size_(max_batch_size), pool_(pooled_batches) {
+
+    if (max_batch_size_ == 0 || pool_.empty()) {
+      throw std::invalid_argument("frame_pipeline needs at least one batch of at least one frame");
+    }
+
+    for (auto& b : pool_) {
+      b.addresses.resize(max_batch_size_);
+      b.frames.resize(max_batch_size_);
+      b.iov.resize(2 * max_batch_size_);
+      free_.push_back(&b);
+    }
+
+    writer_ = std::thread([this]() { writer_loop(); });
+  }
+
+  frame_pipeline(const frame_pipeline&) = delete;
+  frame_pipeline& operator=(const frame_pipeline&) = delete;
+
+  ~frame_pipeline() {
+    flush();
+    { std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+  }
+
+  /**
+   * Encodes the updates and queues them for writing, in as many batches as needed. Blocks only while every
+   * pooled batch is still being written.
+   *
+   * \return false if the writer failed, see error().
+   */
+  bool submit(const config_update<Config>* updates, size_t count) {
+    while (count > 0) {
+      batch* b = acquire();
+      if (b == nullptr) { return false; }
+
+      b->count = std::min(count, max_batch_size_);
+      for (size_t i = 0; i < b->count; ++i) {
+        b->addresses[i] = updates[i].address;
+        b->frames[i] = Binary{};
+        update_all(b->frames[i], updates[i].config);
+
+        b->iov[2 * i] = { &b->addresses[i], sizeof(uint8_t) };
+        b->iov[2 * i + 1] = { &b->frames[i], sizeof(Binary) };
+      }
+
+      { std::lock_guard<std::mutex> lock(mutex_);
+        filled_.push_back(b);
+      }
+      cv_.notify_all();
+
+      updates += b->count;
+      count -= b->count;
+    }
+
+    return error() == 0;
+  }
+
+  /**
+   * Waits until every submitted batch has been written.
+   */
+  bool flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return free_.size() == pool_.size(); });
+    return error() == 0;
+  }
+
+  /**
+   * \return the errno of the failed writev, 0 while everything goes well.
+   */
+  int error() const { return error_.load(std::memory_order_acquire); }
+
+  size_t frames_written() const { return frames_written_.load(std::memory_order_relaxed); }
+
+private:
+
+  struct batch {
+    std::vector<uint8_t> addresses;
+    std::vector<Binary> frames;
+    std::vector<iovec> iov;
+    size_t count = 0;
+  };
+
+  batch* acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !free_.empty() || error() != 0; });
+    if (error() != 0) { return nullptr; }
+    batch* b = free_.front();
+    free_.pop_front();
+    return b;
+  }
+
+  void writer_loop() {
+    for (;;) {
+      batch* b = nullptr;
+      { std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stopping_ || !filled_.empty(); });
+        if (filled_.empty()) { return; }
+        b = filled_.front();
+        filled_.pop_front();
+      }
+
+      if (error() == 0) {
+        int err = writev_all(fd_, b->iov.data(), 2 * b->count);
+        if (err == 0) {
+          frames_written_.fetch_add(b->count, std::memory_order_relaxed);
+        } else {
+          error_.store(err, std::memory_order_release);
+        }
+      }
+
+      { std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(b);
+      }
+      cv_.notify_all();
+    }
+  }
+
+  /**
+   * Writes all iovecs, IOV_MAX at a time, resuming after partial writes.
+   * \return 0 or the errno of the failure.
+   */
+  static int writev_all(int fd, iovec* iov, size_t iovcnt) {
+    while (iovcnt > 0) {
+      ssize_t n = ::writev(fd, iov, static_cast<int>(std::min<size_t>(iovcnt, IOV_MAX)));
+      if (n < 0) {
+        if (errno == EINTR) { continue; }
+        return errno;
+      }
+
+      size_t written = static_cast<size_t>(n);
+      while (iovcnt > 0 && written >= iov->iov_len) {
+        written -= iov->iov_len;
+        ++iov;
+        --iovcnt;
+      }
+
+      if (iovcnt > 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+        iov->iov_len -= written;
+      }
+    }
+    return 0;
+  }
+
+  int fd_;
+  size_t max_batch_size_;
+
+  std::vector<batch> pool_;
+  std::deque<batch*> free_;
+  std::deque<batch*> filled_;
+  bool stopping_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+
+  std::atomic<int> error_{0};
+  std::atomic<size_t> frames_written_{0};
+
+  std::thread writer_;
+};
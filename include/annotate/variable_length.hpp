@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <boost/fusion/include/for_each.hpp>
+#include <boost/fusion/include/size.hpp>
+#include <boost/fusion/include/value_at.hpp>
+
+#include "./member_mapping.hpp"
+
+/*
+ * Variable length fields
+ *
+ * Rationale : A frame with variable length fields cannot be memcpy'd, so its wire struct only holds the values
+ *             and is adapted with BOOST_FUSION_ADAPT_STRUCT to give the order of the fields on the wire. Each
+ *             field kind knows its exact size and its max_size bound at compile time. An encoder can thus
+ *             reserve max_wire_size once for a whole batch, or run a first pass computing the exact sizes and a
+ *             second one writing at the final place, never reallocating.
+ */
+
+/**
+ * Unsigned LEB128 : 7 bits per byte, least significant group first, bit 7 set on all bytes but the last.
+ */
+template <class T>
+struct leb128 {
+  static_assert(std::is_unsigned<T>::value, "leb128 codes unsigned integers");
+
+  static constexpr size_t max_size = (sizeof(T) * 8 + 6) / 7;
+
+  T value{};
+
+  leb128() = default;
+  leb128(T v) : value(v) {}
+  operator T() const { return value; }
+
+  size_t size() const {
+    size_t n = 1;
+    for (T v = value; v >= 0x80; v >>= 7) { ++n; }
+    return n;
+  }
+
+  void write(uint8_t*& out) const {
+    T v = value;
+    for (; v >= 0x80; v >>= 7) { *out++ = static_cast<uint8_t>(v) | 0x80; }
+    *out++ = static_cast<uint8_t>(v);
+  }
+
+  /**
+   * Fails on a truncated value, on more than max_size bytes, and on a last byte carrying bits past T.
+   */
+  bool read(const uint8_t*& in, const uint8_t* end) {
+    value = 0;
+    for (size_t i = 0; i < max_size && in != end; ++i) {
+      uint8_t byte = *in++;
+      if (i == max_size - 1 && ((byte & 0x7F) >> (sizeof(T) * 8 - 7 * i)) != 0) { return false; }
+      value |= T(byte & 0x7F) << (7 * i);
+      if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+  }
+};
+
+/**
+ * Fixed size field, big endian on the wire.
+ */
+template <class T>
+struct fixed {
+  static_assert(std::is_integral<T>::value, "fixed codes integers");
+
+  static constexpr size_t max_size = sizeof(T);
+
+  T value{};
+
+  fixed() = default;
+  fixed(T v) : value(v) {}
+  operator T() const { return value; }
+
+  static constexpr size_t size() { return sizeof(T); }
+
+  void write(uint8_t*& out) const {
+    for (size_t i = sizeof(T); i > 0; --i) {
+      *out++ = static_cast<uint8_t>(static_cast<std::make_unsigned_t<T>>(value) >> (8 * (i - 1)));
+    }
+  }
+
+  bool read(const uint8_t*& in, const uint8_t* end) {
+    if (size_t(end - in) < sizeof(T)) { return false; }
+    std::make_unsigned_t<T> v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) { v = static_cast<std::make_unsigned_t<T>>((v << 8) | *in++); }
+    value = static_cast<T>(v);
+    return true;
+  }
+};
+
+/**
+ * String prefixed by its LEB128 length. Strings longer than MaxLength are cut : the device has no room for more.
+ */
+template <size_t MaxLength>
+struct length_prefixed {
+
+  static constexpr size_t max_size = leb128<size_t>::max_size + MaxLength;
+
+  std::string value;
+
+  length_prefixed() = default;
+  length_prefixed(const std::string& v) : value(v.substr(0, MaxLength)) {}
+  operator std::string() const { return value; }
+
+  size_t size() const { return leb128<size_t>{value.size()}.size() + value.size(); }
+
+  void write(uint8_t*& out) const {
+    leb128<size_t>{value.size()}.write(out);
+    std::memcpy(out, value.data(), value.size());
+    out += value.size();
+  }
+
+  bool read(const uint8_t*& in, const uint8_t* end) {
+    leb128<size_t> length;
+    if (!length.read(in, end) || length.value > MaxLength || length.value > size_t(end - in)) { return false; }
+    value.assign(reinterpret_cast<const char*>(in), length.value);
+    in += length.value;
+    return true;
+  }
+};
+
+template <class Wire, size_t... I>
+constexpr size_t max_wire_size(std::index_sequence<I...>) {
+  return (size_t{0} + ... + boost::fusion::result_of::value_at_c<Wire, I>::type::max_size);
+}
+
+/**
+ * Upper bound of the encoded size of any Wire value.
+ */
+template <class Wire>
+constexpr size_t max_wire_size() {
+  return max_wire_size<Wire>(std::make_index_sequence<boost::fusion::result_of::size<Wire>::value>{});
+}
+
+template <class Wire>
+inline size_t wire_size(const Wire& wire) {
+  size_t size = 0;
+  boost::fusion::for_each(wire, [&size](const auto& field) { size += field.size(); });
+  return size;
+}
+
+template <class Wire>
+inline uint8_t* write_wire(const Wire& wire, uint8_t* out) {
+  boost::fusion::for_each(wire, [&out](const auto& field) { field.write(out); });
+  return out;
+}
+
+template <class Wire>
+inline bool read_wire(Wire& wire, const uint8_t*& in, const uint8_t* end) {
+  bool ok = true;
+  boost::fusion::for_each(wire, [&](auto& field) { ok = ok && field.read(in, end); });
+  return ok;
+}
+
+/**
+ * Two pass batch encoding : exact sizes first, then every frame is written in place in one allocation.
+ * \return the offset of each frame in out, plus the end offset.
+ */
+template <class Wire, class Config>
+inline std::vector<size_t> encode_all(const Config* configs, size_t count, std::vector<uint8_t>& out) {
+  std::vector<Wire> wires(count);
+  std::vector<size_t> offsets(count + 1);
+  offsets[0] = out.size();
+
+  for (size_t i = 0; i < count; ++i) {
+    update_all(wires[i], configs[i]);
+    offsets[i + 1] = offsets[i] + wire_size(wires[i]);
+  }
+
+  out.resize(offsets[count]);
+  for (size_t i = 0; i < count; ++i) {
+    write_wire(wires[i], out.data() + offsets[i]);
+  }
+  return offsets;
+}
+
+/**
+ * Single pass streaming encoding into a buffer reserved for the worst case.
+ */
+template <class Wire, class Config>
+inline size_t encode(const Config& config, std::vector<uint8_t>& out) {
+  Wire wire;
+  update_all(wire, config);
+
+  const size_t offset = out.size();
+  out.resize(offset + max_wire_size<Wire>());
+  uint8_t* end = write_wire(wire, out.data() + offset);
+  out.resize(static_cast<size_t>(end - out.data()));
+  return out.size() - offset;
+}
+
+template <class Wire, class Config>
+inline bool decode(const uint8_t*& in, const uint8_t* end, Config& config) {
+  Wire wire;
+  if (!read_wire(wire, in, end)) { return false; }
+  fill_all(wire, config);
+  return true;
+}
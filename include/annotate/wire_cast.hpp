@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <chrono>
+#include <type_traits>
+
+/**
+ * wire_cast converts a field between its wire type and its model type (e.g. an uint8_t on the wire and a
+ * std::chrono::milliseconds in the model). It works on values because bitfields cannot be bound to references.
+ *
+ * Casters which keep the bits of a value as they are say so with plain = true : the copy plan of member_mapping
+ * copies such fields as bytes. A specialization without it, e.g. a user caster between two integrals of the same
+ * size, is always called.
+ */
+template <class To, class From>
+struct wire_caster {
+  static constexpr bool plain = true;
+  static constexpr To cast(const From& v) { return static_cast<To>(v); }
+};
+
+template <class To, class From, class Enable = void>
+struct wire_cast_plain : std::false_type {};
+
+template <class To, class From>
+struct wire_cast_plain<To, From, std::enable_if_t<wire_caster<To, From>::plain>> : std::true_type {};
+
+template <class Rep, class Period, class From>
+struct wire_caster<std::chrono::duration<Rep, Period>, From> {
+  static constexpr std::chrono::duration<Rep, Period> cast(const From& v) {
+    return std::chrono::duration<Rep, Period>(v);
+  }
+};
+
+template <class To, class Rep, class Period>
+struct wire_caster<To, std::chrono::duration<Rep, Period>> {
+  static constexpr To cast(const std::chrono::duration<Rep, Period>& v) { return static_cast<To>(v.count()); }
+};
+
+template <class Rep, class Period, class FromRep, class FromPeriod>
+struct wire_caster<std::chrono::duration<Rep, Period>, std::chrono::duration<FromRep, FromPeriod>> {
+  static constexpr bool plain =
+    std::is_same<std::chrono::duration<Rep, Period>, std::chrono::duration<FromRep, FromPeriod>>::value;
+  static constexpr std::chrono::duration<Rep, Period> cast(const std::chrono::duration<FromRep, FromPeriod>& v) {
+    return std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(v);
+  }
+};
+
+template <class To, class From>
+constexpr To wire_cast(const From& v) { return wire_caster<To, From>::cast(v); }
+
+/**
+ * Column of N packed bools, LSB first : element i is bit i%8 of bits[i/8].
+ */
+template <size_t N>
+struct bit_column {
+  std::array<uint8_t, (N + 7) / 8> bits;
+};
+
+/**
+ * Element wise conversion of whole columns. The loops have no dependency between elements, which lets the
+ * compiler vectorize them instead of seeing N separate assignments.
+ */
+template <class To, class From, size_t N>
+struct wire_caster<std::array<To, N>, std::array<From, N>> {
+  static constexpr bool plain = wire_cast_plain<To, From>::value;
+  static std::array<To, N> cast(const std::array<From, N>& column) {
+    std::array<To, N> converted;
+    for (size_t i = 0; i < N; ++i) { converted[i] = wire_cast<To>(column[i]); }
+    return converted;
+  }
+};
+
+template <size_t N>
+struct wire_caster<std::array<bool, N>, bit_column<N>> {
+  static std::array<bool, N> cast(const bit_column<N>& column) {
+    std::array<bool, N> converted;
+    for (size_t i = 0; i < N; ++i) { converted[i] = (column.bits[i / 8] >> (i % 8)) & 1; }
+    return converted;
+  }
+};
+
+template <size_t N>
+struct wire_caster<bit_column<N>, std::array<bool, N>> {
+  static bit_column<N> cast(const std::array<bool, N>& values) {
+    bit_column<N> converted{};
+    for (size_t i = 0; i < N; ++i) { converted.bits[i / 8] |= static_cast<uint8_t>(values[i] << (i % 8)); }
+    return converted;
+  }
+};
+
+/**
+ * Member of each element of a model array, mapped to a wire column.
+ */
+template <class Column, class Element, size_t N, class Member>
+inline void fill_column(const Column& column, std::array<Element, N>& elements, Member member) {
+  using value_type = std::decay_t<decltype(member(elements[0]))>;
+  const auto values = wire_cast<std::array<value_type, N>>(column);
+  for (size_t i = 0; i < N; ++i) { member(elements[i]) = values[i]; }
+}
+
+/**
+ * The values of the member of each element, as the column holds them in the model.
+ */
+template <class Element, size_t N, class Member>
+inline auto gather_column(const std::array<Element, N>& elements, Member member) {
+  std::array<std::decay_t<decltype(member(elements[0]))>, N> values;
+  for (size_t i = 0; i < N; ++i) { values[i] = member(elements[i]); }
+  return values;
+}
+
+template <class Column, class Element, size_t N, class Member>
+inline void update_column(Column& column, const std::array<Element, N>& elements, Member member) {
+  column = wire_cast<Column>(gather_column(elements, member));
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/incremental_decode.hpp>
+
+#include "./em510_binary.hpp"
+
+
+/**
+ * An alarm word of which the model only keeps whether any alarm is set, and a level shown twice.
+ */
+namespace config {
+  struct sensor {
+    bool alarm{};
+    uint8_t level{};
+    uint8_t shown_level{};
+  };
+}
+
+struct sensor_binary_representation {
+  uint16_t alarm_word;
+  uint8_t level;
+};
+
+map_to(sensor_binary_representation, config::sensor,
+  ((alarm_word, alarm))
+  ((level, level))
+  ((level, shown_level))
+);
+
+template <class Mapping, class Changes, size_t... I>
+void print_names(const Changes& changed, std::index_sequence<I...>) {
+  ((changed.test(I) ? (std::cout << " " << Mapping::dest_name(std::integral_constant<size_t, I>{})) : std::cout), ...);
+  std::cout << std::endl;
+}
+
+bool same(const config::ey_em510fxx& a, const config::ey_em510fxx& b) {
+  em510_binary_representation x{}, y{};
+  update_all(x, a);
+  update_all(y, b);
+  return std::memcmp(&x, &y, sizeof(x)) == 0;
+}
+
+int main(int argc, char** argv) {
+  using decoder = incremental_decoder<em510_binary_representation, config::ey_em510fxx>;
+
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{20};
+  cfg.relay_26.polarity = true;
+  cfg.ao_09 = 42;
+
+  em510_binary_representation first{};
+  update_all(first, cfg);
+  incremental_state<em510_binary_representation, config::ey_em510fxx> device{first};
+
+  cfg.relay_26.polarity = false;
+  cfg.ai_20 = true;
+  cfg.ao_09 = 43;
+  cfg.relay_27.safety_value = true;
+  em510_binary_representation next = first;
+  update_all(next, cfg);
+
+  auto changed = device.apply(next);
+  std::cout << "changed :";
+  print_names<member_mapping<em510_binary_representation, config::ey_em510fxx>>(changed,
+    decoder::mappings{});
+  assert(changed.count() == 4);
+  assert(same(device.config(), cfg));
+
+  // Reserved bits belong to no field.
+  em510_binary_representation noise = next;
+  noise.bo_polarities.reserved = 3;
+  noise.bi_polarities.reserved_end = 1;
+  assert(device.apply(noise).none());
+
+  // Every field alone is seen, and decoded like a full decode would.
+  for (size_t k = 0; k < 1000; ++k) {
+    em510_binary_representation random = noise;
+    reinterpret_cast<uint8_t*>(&random)[k % sizeof(random)] ^= static_cast<uint8_t>(1u << (k % 8));
+    device.apply(random);
+    config::ey_em510fxx full;
+    fill_all(random, full);
+    assert(same(device.config(), full));
+  }
+
+  // Every bit of a binary field counts, whatever part of it the model keeps, and a bit may feed several fields.
+  {
+    sensor_binary_representation quiet{}, raised{};
+    raised.alarm_word = 0x0100;
+    raised.level = 7;
+    incremental_state<sensor_binary_representation, config::sensor> sensor{quiet};
+    assert(sensor.apply(raised).count() == 3);
+    assert(sensor.config().alarm && sensor.config().level == 7 && sensor.config().shown_level == 7);
+  }
+
+  const size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+  std::array<em510_binary_representation, 2> frames{{first, next}};
+  config::ey_em510fxx out;
+  fill_all(first, out);
+
+  auto start = std::chrono::steady_clock::now();
+  size_t total = 0;
+  for (size_t i = 0; i < iterations; ++i) {
+    total += decoder::decode(frames[i % 2], frames[(i + 1) % 2], out).count();
+  }
+  auto incremental = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    fill_all(frames[(i + 1) % 2], out);
+    asm volatile("" : : "r"(&out) : "memory");
+  }
+  auto full = std::chrono::steady_clock::now() - start;
+
+  std::cout << "incremental decode : " << std::chrono::duration_cast<std::chrono::milliseconds>(incremental).count()
+            << "ms (" << total << " fields), full decode : "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(full).count() << "ms" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/live_state_table.hpp>
+
+#include "./em510_binary.hpp"
+
+
+/**
+ * Every mapped field of frame k is derived from k (modulo what ao_07 and ao_11 can hold), a mixed snapshot would not satisfy is_consistent.
+ */
+em510_binary_representation frame_number(uint64_t k) {
+  k %= 65536;
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{k % 256};
+  cfg.relay_27.polarity = (k % 2) == 1;
+  cfg.ai_22 = (k % 3) == 1;
+  cfg.ao_07 = static_cast<uint8_t>(k);
+  cfg.ao_11 = static_cast<uint8_t>(k >> 8);
+
+  em510_binary_representation frame{};
+  update_all(frame, cfg);
+  return frame;
+}
+
+bool is_consistent(const config::ey_em510fxx& cfg) {
+  const uint64_t k = cfg.ao_07 | (uint64_t{cfg.ao_11} << 8);
+  return cfg.triac_01.pulse_duration == std::chrono::milliseconds{k % 256} &&
+         cfg.relay_27.polarity == ((k % 2) == 1) && cfg.ai_22 == ((k % 3) == 1);
+}
+
+int main(int argc, char** argv) {
+
+  using table_type = live_state_table<em510_binary_representation, config::ey_em510fxx>;
+  static table_type table;
+
+  config::ey_em510fxx cfg;
+  assert(table.read(3, cfg) == snapshot::absent);
+
+  assert(table.update(3, frame_number(1)) == 25);
+  assert(table.update(3, frame_number(1)) == 0);
+  assert(table.update(3, frame_number(2)) > 0);
+  assert(table.version(3) == 6);
+  assert(table.read(3, cfg) == snapshot::consistent);
+  assert(cfg.ao_07 == 2 && is_consistent(cfg));
+
+  // An address off the wire past the table is refused, never written.
+  try {
+    table.update(table_type::size(), frame_number(1));
+    assert(false);
+  } catch (const std::out_of_range&) {
+  }
+  assert(table.read(table_type::size(), cfg) == snapshot::absent && table.version(table_type::size()) == 0);
+
+  constexpr size_t devices = 64;
+  constexpr size_t readers = 8;
+  const uint64_t frames = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+  std::atomic<bool> done{false};
+  std::atomic<uint64_t> reads{0};
+  std::atomic<uint64_t> mixed{0};
+
+  std::vector<std::thread> threads;
+  for (size_t r = 0; r < readers; ++r) {
+    threads.emplace_back([&, r]() {
+      config::ey_em510fxx snapshot_cfg;
+      uint64_t n = 0;
+      uint64_t m = 0;
+      for (size_t address = r; !done.load(std::memory_order_relaxed); address = (address + 1) % devices) {
+        switch (table.read(address, snapshot_cfg)) {
+          case snapshot::consistent: assert(is_consistent(snapshot_cfg)); break;
+          case snapshot::mixed: ++m; break;
+          case snapshot::absent: break;
+        }
+        assert(!table.read_consistent(address, snapshot_cfg) || is_consistent(snapshot_cfg));
+        ++n;
+      }
+      reads += n;
+      mixed += m;
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t k = 0; k < frames; ++k) {
+    table.update(k % devices, frame_number(k));
+  }
+  done = true;
+  for (auto& t : threads) { t.join(); }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  std::cout << frames << " frames decoded in place and " << reads << " reads in " << elapsed.count() << "ms, "
+            << mixed << " reads saw a frame being decoded" << std::endl;
+
+  return 0;
+}
@@ -8,95 +8,15 @@
 #include <boost/preprocessor/facilities/expand.hpp>
 #include <boost/preprocessor/variadic/elem.hpp>
 #include <boost/preprocessor/variadic/to_seq.hpp>
-#include <boost/mpl/list.hpp>
 #include <boost/fusion/include/adapt_struct.hpp>
 #include <boost/endian/buffers.hpp>  // see Synopsis below
 #include <functional>
 #include <array>
 
-#include <boost/metaparse/string.hpp>
-//#include <boost/type_index.hpp>
-
-
-/*
- * FRAMEWORK CODE for the Binary toolkit
- */
-constexpr size_t operator "" _bits(unsigned long long val) { return val; }
-constexpr size_t operator "" _byte(unsigned long long val) { return val; }
-
-/**
- * Rationale : The anchor_LINE typedef is made of a METAPARSE_STRING because this way we get an unique type for each
- *             field, based on their name. We cannot rely on the field member pointer, as it doesn't work for bitfields,
- *             and our first target for this member mapping library is binary serialization. And we want to map smaller than
- *             a byte.
- *
- */ 
-
-#define get_annotations_on_each(r, data, elem) , elem
-
-
-#define 📜(field, ...)                                                                                                      \
-  auto get_annotations( BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(field)) ) { \
-                                                                                                                     \
-    return std::make_tuple(                                                                                                         \
-       bool{} BOOST_PP_SEQ_FOR_EACH(get_annotations_on_each, unused,                                                   \
-       BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__) )                    \
-    );                                                                                                               \
-  }
-
-
-#define annotated_on_each(r, data, elem) , BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(elem))
-
-#define annotated(...) \
-  typedef boost::mpl::list< bool \
-    BOOST_PP_SEQ_FOR_EACH(annotated_on_each, unused, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__)) \
-  > annotated;
-
-
-struct jsonize {};
-
-
-template<class srcpath, class dstpath>
-struct map_to {
-  std::function<srcpath> fill_src;
-  std::function<dstpath> fill_dst;
-};
-
-#define member_map(srcpath, dsttype, dstpath)                                     \
-  (map_to< void( decltype(*this)& src, const dsttype& dst ) , void( decltype(*this)& src, dsttype& dst ) > {\
-    []( decltype(*this)& src, const dsttype& dst ) { src. srcpath = dst. dstpath; }, \
-    []( decltype(*this)& src, dsttype& dst ) { dst. dstpath = src. srcpath; } \
-  })
-
-
-
-// Easier syntax
-
-#define 📃(field) \
-  field; using BOOST_PP_CAT(anchor_, __LINE__ ) = BOOST_METAPARSE_STRING(BOOST_PP_STRINGIZE(field)); \
-  auto& BOOST_PP_CAT(get_anchor_, __LINE__ )() { return field; }
-
-  
-#define 📒(...) \
-  auto get_annotations( BOOST_PP_CAT(anchor_, __LINE__ ) ) { \
-                                                                                                                     \
-    return std::make_tuple(                                                                                                         \
-       bool{} BOOST_PP_SEQ_FOR_EACH(get_annotations_on_each, unused,                                                   \
-       BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__) )                    \
-    );                                                                                                               \
-  }
-
-#define member_mapv3(dsttype, dstpath)                                     \
-  (map_to< void( decltype(*this)& src, const dsttype& dst ) , void( decltype(*this)& src, dsttype& dst ) > {\
-    [this]( decltype(*this)& src, const dsttype& dst ) { BOOST_PP_CAT(get_anchor_, __LINE__ )() = dst. dstpath; }, \
-    [this]( decltype(*this)& src, dsttype& dst ) { dst. dstpath = BOOST_PP_CAT(get_anchor_, __LINE__ )(); } \
-  })
-
-
-
-
-
+#include <annotate/literals.hpp>
+#include <annotate/annotations.hpp>
 
+//#include <boost/type_index.hpp>
 
 
 /*
@@ -144,20 +64,20 @@ namespace config {
 struct binary_representation {
   annotated(pulse_for_triac01, pulse_for_triac03, bo_polarities)
 
-  uint8_t 📃(pulse_for_triac01); 📒(member_mapv3(config::ey_em510fxx, triac_01.pulse_duration))
+  uint8_t 📃(pulse_for_triac01); 📒(annotate_mapv3(config::ey_em510fxx, triac_01.pulse_duration))
 
 
   //📜(pulse_for_triac01,
-  //    member_map(pulse_for_triac01, config::ey_em510fxx, triac_01.pulse_duration) , jsonize{} )
+  //    annotate_map(pulse_for_triac01, config::ey_em510fxx, triac_01.pulse_duration) , jsonize{} )
   //uint8_t pulse_for_triac01;
 
   📜(pulse_for_triac03, 
-      member_map(pulse_for_triac01, config::ey_em510fxx, triac_03.pulse_duration), jsonize{} )
+      annotate_map(pulse_for_triac01, config::ey_em510fxx, triac_03.pulse_duration), jsonize{} )
 
   uint8_t pulse_for_triac03;
 
   📜(pulse_for_triac05,
-      member_map(pulse_for_triac01, config::ey_em510fxx, triac_05.pulse_duration) )
+      annotate_map(pulse_for_triac01, config::ey_em510fxx, triac_05.pulse_duration) )
   uint8_t pulse_for_triac05;
 
 
@@ -170,9 +90,9 @@ struct binary_representation {
     bool triac_03                             : 1_bits;
     bool triac_05                             : 1_bits;
 
-    📜(triac_01, member_map(triac_01, config::ey_em510fxx, triac_01.polarity) , jsonize{} )
-    📜(triac_03, member_map(triac_03, config::ey_em510fxx, triac_03.polarity) )
-    📜(triac_05, member_map(triac_05, config::ey_em510fxx, triac_05.polarity) )
+    📜(triac_01, annotate_map(triac_01, config::ey_em510fxx, triac_01.polarity) , jsonize{} )
+    📜(triac_03, annotate_map(triac_03, config::ey_em510fxx, triac_03.polarity) )
+    📜(triac_05, annotate_map(triac_05, config::ey_em510fxx, triac_05.polarity) )
 
     uint8_t reserved_at_end                   : 3_bits;
 
@@ -6,71 +6,20 @@
 #include <boost/preprocessor/tuple/elem.hpp>
 #include <boost/preprocessor/punctuation/remove_parens.hpp>
 #include <boost/preprocessor/facilities/expand.hpp>
-#include <boost/mpl/range_c.hpp>
 #include <boost/fusion/include/adapt_struct.hpp>
 #include <boost/endian/buffers.hpp>  // see Synopsis below
 #include <functional>
 #include <array>
 
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+
 #include <boost/type_index.hpp>
 
 using namespace boost::endian;
 
 
 
-/*
- * Binary toolkit
- */
-constexpr size_t operator "" _bits(unsigned long long val) { return val; }
-constexpr size_t operator "" _byte(unsigned long long val) { return val; }
-
-
-  template <class T, const T>
-  struct mapping {};
-
-
-#define mapping_for(member_pointer) mapping<decltype(member_pointer), member_pointer>
-
-#define member_map(id, srcpath, destpath)                                                                      \
-  typedef std::integral_constant<size_t, id> BOOST_PP_CAT(anchor_ , id);                  \
-  void fill(BOOST_PP_CAT(anchor_ , id), const src_type& s, dest_type& d) const { d. destpath = s. srcpath; }                          \
-  void update(BOOST_PP_CAT(anchor_ , id), src_type& s, const dest_type& d) { s. srcpath = d. destpath; }                        \
-
-template <class SRC, class DEST>
-struct member_mapping : public std::false_type {};
-
-#define MEMBER_MAPPINGS_ON_EACH(r, data, elem) \
-  member_map( r,  BOOST_PP_TUPLE_ELEM( 2, 0, elem), BOOST_PP_TUPLE_ELEM(2, 1, elem) )
-
-#define MAKE_ELEM_ID(r, data, elem) \
-  , BOOST_PP_CAT(anchor_ , r)
-
-   
-#define map_to(SRC_TYPE, DEST_TYPE, MAPPINGS)                   \
-  template<>                                                    \
-  struct member_mapping<SRC_TYPE, DEST_TYPE> {                  \
-                                                                \
-    typedef SRC_TYPE src_type;                                  \
-    typedef DEST_TYPE dest_type;                                \
-                                                                \
-                                                                \
-    typedef boost::mpl::range_c<size_t, 2, 1 + BOOST_PP_SEQ_SIZE(MAPPINGS)> mappings; \
-                                                                \
-    BOOST_PP_SEQ_FOR_EACH(MEMBER_MAPPINGS_ON_EACH, _, MAPPINGS )    \
-  };                                                            \
-
-
-
-
-
-
-
-
-
-
-
-
-
 /*
  * -------------------------- USER code Model domain -----------------------------------
  */
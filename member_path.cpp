@@ -2,7 +2,6 @@
 
 #include <cstdio>
 #include <memory>
-#include <pre/bytes/utils.hpp>
 
 #include <boost/fusion/include/adapt_struct.hpp>
 #include <boost/fusion/include/for_each.hpp>
@@ -0,0 +1,151 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <annotate/literals.hpp>
+#include <annotate/wire_cast.hpp>
+#include <annotate/annotations.hpp>
+#include <annotate/trace.hpp>
+
+#include "./em510_model.hpp"
+
+
+/*
+ * -------------------------- USER BINARY SERIALIZATION CODE -----------------------------------
+ */
+
+struct em510_binary_representation {
+  annotated(triac_01_pulse_duration, triac_03_pulse_duration, triac_05_pulse_duration,
+            relay_25_pulse_duration, relay_26_pulse_duration, relay_27_pulse_duration,
+            bo_polarities.triac_01, bo_polarities.triac_03, bo_polarities.triac_05,
+            bo_polarities.relay_25, bo_polarities.relay_26, bo_polarities.relay_27,
+            bi_polarities.ai_18, bi_polarities.ai_20, bi_polarities.ai_22, bi_polarities.ai_23,
+            ao_07_safety_value, ao_09_safety_value, ao_11_safety_value,
+            bo_safety_values.triac_01, bo_safety_values.triac_03, bo_safety_values.triac_05,
+            bo_safety_values.relay_25, bo_safety_values.relay_26, bo_safety_values.relay_27)
+
+  uint8_t 📃(triac_01_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, triac_01.pulse_duration), trace{})
+  uint8_t 📃(triac_03_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, triac_03.pulse_duration), trace{})
+  uint8_t 📃(triac_05_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, triac_05.pulse_duration), trace{})
+
+  uint8_t 📃(relay_25_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, relay_25.pulse_duration), jsonize{})
+  uint8_t 📃(relay_26_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, relay_26.pulse_duration), jsonize{})
+  uint8_t 📃(relay_27_pulse_duration); 📒(annotate_mapv3(config::ey_em510fxx, relay_27.pulse_duration), jsonize{})
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+    bool triac_05                             : 1_bits;
+
+    bool relay_25                             : 1_bits;
+    bool relay_26                             : 1_bits;
+    bool relay_27                             : 1_bits;
+  } bo_polarities;
+
+  📜(bo_polarities.triac_01, annotate_map(bo_polarities.triac_01, config::ey_em510fxx, triac_01.polarity), trace{}, jsonize{})
+  📜(bo_polarities.triac_03, annotate_map(bo_polarities.triac_03, config::ey_em510fxx, triac_03.polarity), trace{})
+  📜(bo_polarities.triac_05, annotate_map(bo_polarities.triac_05, config::ey_em510fxx, triac_05.polarity), trace{})
+  📜(bo_polarities.relay_25, annotate_map(bo_polarities.relay_25, config::ey_em510fxx, relay_25.polarity))
+  📜(bo_polarities.relay_26, annotate_map(bo_polarities.relay_26, config::ey_em510fxx, relay_26.polarity))
+  📜(bo_polarities.relay_27, annotate_map(bo_polarities.relay_27, config::ey_em510fxx, relay_27.polarity))
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool ai_18                                : 1_bits;
+    bool ai_20                                : 1_bits;
+    bool ai_22                                : 1_bits;
+    bool ai_23                                : 1_bits;
+
+    uint8_t reserved_end                      : 2_bits;
+  } bi_polarities;
+
+  📜(bi_polarities.ai_18, annotate_map(bi_polarities.ai_18, config::ey_em510fxx, ai_18), trace{})
+  📜(bi_polarities.ai_20, annotate_map(bi_polarities.ai_20, config::ey_em510fxx, ai_20), trace{})
+  📜(bi_polarities.ai_22, annotate_map(bi_polarities.ai_22, config::ey_em510fxx, ai_22), trace{})
+  📜(bi_polarities.ai_23, annotate_map(bi_polarities.ai_23, config::ey_em510fxx, ai_23), trace{})
+
+  uint8_t 📃(ao_07_safety_value); 📒(annotate_mapv3(config::ey_em510fxx, ao_07), trace{})
+  uint8_t 📃(ao_09_safety_value); 📒(annotate_mapv3(config::ey_em510fxx, ao_09), trace{})
+  uint8_t 📃(ao_11_safety_value); 📒(annotate_mapv3(config::ey_em510fxx, ao_11), trace{})
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 2_bits;
+
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+    bool triac_05                             : 1_bits;
+
+    bool relay_25                             : 1_bits;
+    bool relay_26                             : 1_bits;
+    bool relay_27                             : 1_bits;
+  } bo_safety_values;
+
+  📜(bo_safety_values.triac_01, annotate_map(bo_safety_values.triac_01, config::ey_em510fxx, triac_01.safety_value), trace{})
+  📜(bo_safety_values.triac_03, annotate_map(bo_safety_values.triac_03, config::ey_em510fxx, triac_03.safety_value), trace{})
+  📜(bo_safety_values.triac_05, annotate_map(bo_safety_values.triac_05, config::ey_em510fxx, triac_05.safety_value), trace{})
+  📜(bo_safety_values.relay_25, annotate_map(bo_safety_values.relay_25, config::ey_em510fxx, relay_25.safety_value))
+  📜(bo_safety_values.relay_26, annotate_map(bo_safety_values.relay_26, config::ey_em510fxx, relay_26.safety_value))
+  📜(bo_safety_values.relay_27, annotate_map(bo_safety_values.relay_27, config::ey_em510fxx, relay_27.safety_value))
+};
+
+
+int main(int argc, char** argv) {
+
+  config::ey_em510fxx internal{};
+  internal.triac_01.pulse_duration = std::chrono::milliseconds{120};
+  internal.triac_03.polarity = true;
+  internal.ai_23 = true;
+  internal.ao_09 = 42;
+
+  constexpr size_t rounds = 10000;
+
+  auto convert = [&]() {
+    for (size_t i = 0; i < rounds; ++i) {
+      em510_binary_representation bin{};
+      encode(bin, internal);
+
+      config::ey_em510fxx decoded{};
+      decode(bin, decoded);
+
+      assert(decoded.triac_01.pulse_duration == internal.triac_01.pulse_duration);
+      assert(decoded.triac_03.polarity == internal.triac_03.polarity);
+      assert(decoded.ai_23 == internal.ai_23);
+      assert(decoded.ao_09 == internal.ao_09);
+    }
+  };
+
+  std::thread other{convert};
+  convert();
+  other.join();
+
+  if (!trace_enabled) {
+    std::cout << "tracing is compiled out, build with -DANNOTATE_TRACE" << std::endl;
+    return 0;
+  }
+
+  auto report = trace_report<em510_binary_representation>("em510_binary_representation");
+
+  // 2 threads, each encoding and decoding every round.
+  assert(report[0].conversions == 2 * 2 * rounds);
+  assert(report[1].conversions == 2 * 2 * rounds);   // triac_01_pulse_duration has trace{}
+  assert(report[4].conversions == 0);                // relay_25_pulse_duration only has jsonize{}
+
+  std::sort(report.begin() + 1, report.end(), [](auto& a, auto& b) { return a.cycles > b.cycles; });
+  for (auto& sample : report) {
+    std::cout << std::setw(56) << std::left << sample.field
+              << std::setw(12) << sample.conversions
+              << std::setw(12) << sample.bytes
+              << sample.cycles << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <chrono>
+#include <annotate/member_mapping.hpp>
+#include <annotate/modbus.hpp>
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  struct binary_output_config {
+
+    /**
+     * Duration of the Pulse signal (0 to 255ms)
+     */
+    std::chrono::milliseconds pulse_duration{0};
+
+    /**
+     * Determine channel polarity, which will be used to interpret further channel values.
+     */
+    bool polarity{};
+
+    /**
+     * Value used by the rio in case nothing provided
+     */
+    bool safety_value{};
+  };
+
+  using binary_input_config = bool;
+  using analog_output_value = uint8_t;
+
+  struct remote_io {
+    /**
+     * Timeout that the device should wait for replies
+     */
+    std::chrono::seconds slc_timeout{10};
+
+    /**
+     * deadtime_timeout in 10th of seconds (1/10)
+     */
+    std::chrono::duration<int, std::deci> deadtime_timeout{10};
+
+    /**
+     * Time for the rio to startup
+     */
+    std::chrono::seconds powerup_timeout{1};
+  };
+
+  /**
+   * Remote IO EY-EM510FXXX
+   *
+   * ![Mapping EY-EM510FXXX](../doc/diagrams/ey_em510fxx.png)
+   */
+  struct ey_em510fxx : public remote_io {
+
+    ey_em510fxx() : remote_io() {}
+
+    binary_output_config triac_01{};
+    binary_output_config triac_03{};
+    binary_output_config triac_05{};
+
+    binary_output_config relay_25{};
+    binary_output_config relay_26{};
+    binary_output_config relay_27{};
+
+    binary_input_config ai_18{};
+    binary_input_config ai_20{};
+    binary_input_config ai_22{};
+    binary_input_config ai_23{};
+
+    analog_output_value ao_07{};
+    analog_output_value ao_09{};
+    analog_output_value ao_11{};
+
+  };
+
+}
+
+/**
+ * The EM510 on the fieldbus : one holding register per value, slc_timeout on two since it counts seconds up
+ * to a day, one coil per bool.
+ */
+modbus_map(em510_registers, config::ey_em510fxx,
+  ((triac_01.pulse_duration, 1))
+  ((triac_03.pulse_duration, 1))
+  ((triac_05.pulse_duration, 1))
+  ((relay_25.pulse_duration, 1))
+  ((relay_26.pulse_duration, 1))
+  ((relay_27.pulse_duration, 1))
+  ((ao_07))
+  ((ao_09))
+  ((ao_11))
+  ((slc_timeout, 2))
+  ((deadtime_timeout, 1))
+  ((powerup_timeout, 1)),
+
+  ((triac_01.polarity))
+  ((triac_03.polarity))
+  ((triac_05.polarity))
+  ((relay_25.polarity))
+  ((relay_26.polarity))
+  ((relay_27.polarity))
+  ((ai_18))
+  ((ai_20))
+  ((ai_22))
+  ((ai_23))
+  ((triac_01.safety_value))
+  ((triac_03.safety_value))
+  ((triac_05.safety_value))
+  ((relay_25.safety_value))
+  ((relay_26.safety_value))
+  ((relay_27.safety_value))
+);
+
+static_assert(em510_registers::holding_registers == 13, "12 values, slc_timeout on two registers");
+static_assert(em510_registers::plan.addresses[9] == 9 && em510_registers::plan.addresses[10] == 11,
+              "deadtime_timeout after the two registers of slc_timeout");
+static_assert(em510_registers::coils == 16, "16 bools");
+
+template <class Mapping, size_t... I>
+void print_registers(std::index_sequence<I...>) {
+  using image = typename Mapping::src_type;
+  ((std::cout << std::setw(24) << std::left << Mapping::dest_name(std::integral_constant<size_t, I>{})
+              << " register " << image::plan.addresses[I] << " x" << image::register_counts[I] << "\n"), ...);
+}
+
+bool same_config(const config::ey_em510fxx& a, const config::ey_em510fxx& b) {
+  return a.triac_01.pulse_duration == b.triac_01.pulse_duration &&
+    a.relay_27.pulse_duration == b.relay_27.pulse_duration &&
+    a.triac_03.polarity == b.triac_03.polarity && a.relay_26.polarity == b.relay_26.polarity &&
+    a.ai_18 == b.ai_18 && a.ai_23 == b.ai_23 &&
+    a.ao_07 == b.ao_07 && a.ao_11 == b.ao_11 &&
+    a.triac_05.safety_value == b.triac_05.safety_value && a.relay_27.safety_value == b.relay_27.safety_value &&
+    a.slc_timeout == b.slc_timeout && a.deadtime_timeout == b.deadtime_timeout &&
+    a.powerup_timeout == b.powerup_timeout;
+}
+
+int main(int argc, char** argv) {
+  using mapping = member_mapping<em510_registers, config::ey_em510fxx>;
+  using fields = modbus::fields<em510_registers>;
+  print_registers<mapping>(std::make_index_sequence<em510_registers::register_fields>{});
+
+  const size_t cycles = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  modbus::fake_slave<em510_registers> slave;
+  modbus::master<em510_registers> master(
+    [&](const uint8_t* request, size_t size, uint8_t* response) { return slave.handle(request, size, response); });
+
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{20};
+  cfg.relay_27.pulse_duration = std::chrono::milliseconds{255};
+  cfg.triac_03.polarity = true;
+  cfg.relay_26.polarity = true;
+  cfg.ai_23 = true;
+  cfg.ao_07 = 7;
+  cfg.ao_11 = 200;
+  cfg.triac_05.safety_value = true;
+  cfg.slc_timeout = std::chrono::seconds{86400};
+  cfg.deadtime_timeout = std::chrono::duration<int, std::deci>{25};
+
+  assert(master.write(cfg) == modbus::exception::none);
+  assert(same_config(slave.config(), cfg));
+  assert(slave.requests() == master.write_requests() && master.write_requests() == 2);
+
+  config::ey_em510fxx polled;
+  polled.slc_timeout = polled.powerup_timeout = std::chrono::seconds{0};
+  assert(master.read(polled) == modbus::exception::none);
+  assert(same_config(polled, cfg));
+
+  // The device changes a value : a partial poll of the analog registers sees it.
+  slave.config().ao_09 = 99;
+  modbus::range_plan analog;
+  assert(fields::plan_registers(6, 3, analog));
+  assert(master.read_registers(analog, polled) == modbus::exception::none);
+  assert(polled.ao_09 == 99);
+
+  // A range splitting slc_timeout reads its registers but decodes only the whole fields.
+  modbus::range_plan split;
+  assert(fields::plan_registers(8, 2, split));
+  assert(split.first_field == 8 && split.end_field == 10 && split.first_whole == 8 && split.end_whole == 9);
+
+  // Out of the image, the slave answers an exception.
+  modbus::range_plan beyond;
+  assert(!fields::plan_registers(10, 5, beyond));
+  beyond.start = 10;
+  beyond.count = 5;
+  assert(master.read_registers(beyond, polled) == modbus::exception::illegal_data_address);
+
+  // Poll cycles : the whole image in bulk, against one request per register and per coil.
+  std::array<modbus::range_plan, em510_registers::holding_registers> one_register;
+  for (size_t i = 0; i < one_register.size(); ++i) { fields::plan_registers(i, 1, one_register[i]); }
+  std::array<modbus::range_plan, em510_registers::coils> one_coil;
+  for (size_t i = 0; i < one_coil.size(); ++i) { fields::plan_coils(i, 1, one_coil[i]); }
+
+  size_t before = slave.requests();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t c = 0; c < cycles; ++c) {
+    slave.config().ao_07 = static_cast<uint8_t>(c);
+    master.read(polled);
+    assert(polled.ao_07 == static_cast<uint8_t>(c));
+  }
+  auto bulk = std::chrono::steady_clock::now() - start;
+  const size_t bulk_requests = (slave.requests() - before) / cycles;
+
+  before = slave.requests();
+  start = std::chrono::steady_clock::now();
+  for (size_t c = 0; c < cycles; ++c) {
+    slave.config().ao_07 = static_cast<uint8_t>(c);
+    for (auto& plan : one_register) { master.read_registers(plan, polled); }
+    for (auto& plan : one_coil) { master.read_coils(plan, polled); }
+    assert(polled.ao_07 == static_cast<uint8_t>(c));
+  }
+  auto single = std::chrono::steady_clock::now() - start;
+  const size_t single_requests = (slave.requests() - before) / cycles;
+
+  assert(same_config(polled, slave.config()));
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << "bulk poll : " << bulk_requests << " requests, "
+            << std::chrono::duration_cast<ns>(bulk).count() / double(cycles) << " ns per cycle\n"
+            << "register by register : " << single_requests << " requests, "
+            << std::chrono::duration_cast<ns>(single).count() / double(cycles) << " ns per cycle" << std::endl;
+  return 0;
+}
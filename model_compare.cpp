@@ -0,0 +1,93 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/model_compare.hpp>
+
+#include "./em510_binary.hpp"
+
+mapped_comparisons(em510_binary_representation, config::ey_em510fxx)
+
+/**
+ * What the dedup pass did before : encode the config, compare and hash the frame.
+ */
+std::string encoded(const config::ey_em510fxx& cfg) {
+  em510_binary_representation frame;
+  std::memset(&frame, 0, sizeof(em510_binary_representation));
+  update_all(frame, cfg);
+  return std::string(reinterpret_cast<const char*>(&frame), sizeof(em510_binary_representation));
+}
+
+bool same_frames(const config::ey_em510fxx& a, const config::ey_em510fxx& b) {
+  em510_binary_representation x, y;
+  std::memset(&x, 0, sizeof(em510_binary_representation));
+  std::memset(&y, 0, sizeof(em510_binary_representation));
+  update_all(x, a);
+  update_all(y, b);
+  return std::memcmp(&x, &y, sizeof(em510_binary_representation)) == 0;
+}
+
+int main(int argc, char** argv) {
+  const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+  // States of a fleet : few distinct configs, timeouts the binary does not carry differ anyway. A window which
+  // stays in cache, gone through count times : the comparisons, not the memory, are measured.
+  const size_t window = 4096;
+  std::mt19937 random(11);
+  std::vector<config::ey_em510fxx> states(window);
+  for (auto& cfg : states) {
+    const uint32_t r = random();
+    cfg.triac_01.polarity = r & 1;
+    cfg.relay_27.safety_value = (r >> 1) & 1;
+    cfg.ao_09 = static_cast<uint8_t>((r >> 2) & 0x3);
+    cfg.triac_05.pulse_duration = std::chrono::milliseconds{ (r >> 4) & 0x7 };
+    cfg.slc_timeout = std::chrono::seconds{ random() % 60 };
+  }
+
+  // Consecutive duplicates.
+  size_t frames_changes = 0, fields_changes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 1; k < count; ++k) { frames_changes += !same_frames(states[(k - 1) % window], states[k % window]); }
+  auto frames_equal = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (size_t k = 1; k < count; ++k) {
+    fields_changes += !std::equal_to<config::ey_em510fxx>{}(states[(k - 1) % window], states[k % window]);
+  }
+  auto fields_equal = std::chrono::steady_clock::now() - start;
+
+  assert(frames_changes == fields_changes);
+
+  // Distinct configs.
+  std::unordered_map<std::string, size_t> by_frame;
+  start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) { ++by_frame[encoded(states[k % window])]; }
+  auto frames_dedup = std::chrono::steady_clock::now() - start;
+
+  std::unordered_map<config::ey_em510fxx, size_t> by_fields;
+  start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) { ++by_fields[states[k % window]]; }
+  auto fields_dedup = std::chrono::steady_clock::now() - start;
+
+  assert(by_frame.size() == by_fields.size() && by_fields.size() == 128);
+  for (const auto& entry : by_fields) { assert(by_frame.at(encoded(entry.first)) == entry.second); }
+
+  using ns = std::chrono::nanoseconds;
+  auto per_config = [&](auto d) { return std::chrono::duration_cast<ns>(d).count() / double(count); };
+  std::cout << count << " configs, " << fields_changes << " changes, " << by_fields.size() << " distinct\n"
+            << "equality, frames : " << per_config(frames_equal) << " ns, mapped fields : "
+            << per_config(fields_equal) << " ns\n"
+            << "dedup, frames : " << per_config(frames_dedup) << " ns, mapped fields : "
+            << per_config(fields_dedup) << " ns" << std::endl;
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <initializer_list>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/observer.hpp>
+
+#include "./em510_binary.hpp"
+
+using observer = field_observer<em510_binary_representation, config::ey_em510fxx>;
+
+/**
+ * What a consumer did before : keep its own copy of every device, diff the whole config after each decode and
+ * look for its fields among the changed ones.
+ */
+using mapping = member_mapping<em510_binary_representation, config::ey_em510fxx>;
+
+template <size_t... I>
+observer::changes diff(const config::ey_em510fxx& a, const config::ey_em510fxx& b, std::index_sequence<I...>) {
+  observer::changes changed;
+  ((changed[I] = !(mapping::dest_value(std::integral_constant<size_t, I>{}, a) ==
+                   mapping::dest_value(std::integral_constant<size_t, I>{}, b))), ...);
+  return changed;
+}
+
+struct polling_consumer {
+  observer::changes fields;
+  std::vector<config::ey_em510fxx> seen;
+  size_t changes = 0;
+
+  polling_consumer(std::initializer_list<const char*> names, size_t devices) : seen(devices) {
+    for (const char* name : names) { fields.set(observer::field_index(name)); }
+  }
+
+  void poll(uint32_t device, const config::ey_em510fxx& cfg) {
+    if ((diff(seen[device], cfg, mapping::mappings{}) & fields).any()) { ++changes; }
+    seen[device] = cfg;
+  }
+};
+
+int main(int argc, char** argv) {
+  const size_t decodes = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+  const size_t devices = 64;
+
+  // Frames where a field changes now and then, like a status stream.
+  std::mt19937 random(7);
+  std::vector<config::ey_em510fxx> states(devices);
+  std::vector<std::pair<uint32_t, em510_binary_representation>> frames(decodes);
+  for (auto& f : frames) {
+    f.first = random() % devices;
+    config::ey_em510fxx& cfg = states[f.first];
+    switch (random() % 16) {
+      case 0: cfg.triac_01.polarity = !cfg.triac_01.polarity; break;
+      case 1: cfg.relay_27.polarity = !cfg.relay_27.polarity; break;
+      case 2: cfg.ao_09 = static_cast<uint8_t>(random()); break;
+      case 3: cfg.triac_01.pulse_duration = std::chrono::milliseconds{random() % 256}; break;
+      case 4: cfg.ai_20 = !cfg.ai_20; break;
+      default: break;
+    }
+    std::memset(&f.second, 0, sizeof(em510_binary_representation));
+    update_all(f.second, cfg);
+  }
+
+  observer obs;
+  size_t safety_calls = 0, safety_changes = 0, analog_calls = 0, pulse_calls = 0;
+  obs.subscribe({ "triac_01.polarity", "relay_27.polarity" },
+    [&](uint32_t, const config::ey_em510fxx&, const observer::changes& changed) {
+      ++safety_calls;
+      safety_changes += changed.count();
+    });
+  obs.subscribe({ "ao_07", "ao_09", "ao_11" },
+    [&](uint32_t, const config::ey_em510fxx&, const observer::changes& changed) {
+      assert(changed.test(observer::field_index("ao_09")));
+      ++analog_calls;
+    });
+  const size_t pulses = obs.subscribe({ "triac_01.pulse_duration" },
+    [&](uint32_t, const config::ey_em510fxx& cfg, const observer::changes&) {
+      assert(cfg.triac_01.pulse_duration.count() < 256);
+      ++pulse_calls;
+    });
+
+  try {
+    obs.subscribe({ "triac_02.polarity" }, nullptr);
+    assert(false);
+  } catch (const std::invalid_argument&) {}
+
+  std::vector<config::ey_em510fxx> decoded(devices);
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& f : frames) { obs.decode(f.first, f.second, decoded[f.first]); }
+  auto observed = std::chrono::steady_clock::now() - start;
+
+  // The same consumers, each diffing the whole config.
+  polling_consumer safety({ "triac_01.polarity", "relay_27.polarity" }, devices);
+  polling_consumer analog({ "ao_07", "ao_09", "ao_11" }, devices);
+  polling_consumer pulse({ "triac_01.pulse_duration" }, devices);
+  std::vector<config::ey_em510fxx> polled(devices);
+  start = std::chrono::steady_clock::now();
+  for (const auto& f : frames) {
+    config::ey_em510fxx& cfg = polled[f.first];
+    fill_all(f.second, cfg);
+    safety.poll(f.first, cfg);
+    analog.poll(f.first, cfg);
+    pulse.poll(f.first, cfg);
+  }
+  auto polling = std::chrono::steady_clock::now() - start;
+
+  assert(safety_calls == safety.changes && analog_calls == analog.changes && pulse_calls == pulse.changes);
+  assert(safety_changes >= safety_calls);
+
+  // Unsubscribed, triac_01.pulse_duration is no longer compared.
+  obs.unsubscribe(pulses);
+  assert(obs.watched().size() == 5);
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << decodes << " decodes, " << safety_calls + analog_calls + pulse_calls << " notifications\n"
+            << "observer : " << std::chrono::duration_cast<ns>(observed).count() / double(decodes)
+            << " ns per decode, consumers polling : "
+            << std::chrono::duration_cast<ns>(polling).count() / double(decodes) << " ns per decode" << std::endl;
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <array>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/packed_layout.hpp>
+
+#include "./em510_binary.hpp"
+
+/**
+ * The same fields as em510_binary_representation, plus the timeouts of remote_io, in a layout computed by the
+ * framework : for the logs and the IPC of our own services, which never talk to the device itself.
+ */
+packed_layout(em510_packed, config::ey_em510fxx,
+  ((triac_01.pulse_duration, 8_bits))
+  ((triac_03.pulse_duration, 8_bits))
+  ((triac_05.pulse_duration, 8_bits))
+  ((relay_25.pulse_duration, 8_bits))
+  ((relay_26.pulse_duration, 8_bits))
+  ((relay_27.pulse_duration, 8_bits))
+  ((triac_01.polarity))
+  ((triac_03.polarity))
+  ((triac_05.polarity))
+  ((relay_25.polarity))
+  ((relay_26.polarity))
+  ((relay_27.polarity))
+  ((ai_18))
+  ((ai_20))
+  ((ai_22))
+  ((ai_23))
+  ((ao_07))
+  ((ao_09))
+  ((ao_11))
+  ((triac_01.safety_value))
+  ((triac_03.safety_value))
+  ((triac_05.safety_value))
+  ((relay_25.safety_value))
+  ((relay_26.safety_value))
+  ((relay_27.safety_value))
+  ((slc_timeout, 16_bits))
+  ((deadtime_timeout, 8_bits))
+  ((powerup_timeout, 8_bits))
+);
+
+static_assert(em510_packed::size == 15, "13 whole bytes of durations, timeouts and analog values, 2 of bools");
+static_assert(sizeof(em510_packed) == em510_packed::size, "no padding");
+static_assert(em510_packed::plan.offsets[25] == 0, "the widest field first, aligned for a 16 bits load");
+static_assert(em510_packed::plan.offsets[6] == 13 * 8, "bools after the whole bytes");
+
+template <class Mapping, size_t... I>
+void print_plan(std::index_sequence<I...>) {
+  using frame = typename Mapping::src_type;
+  ((std::cout << std::setw(24) << std::left << Mapping::dest_name(std::integral_constant<size_t, I>{})
+              << " bit " << std::setw(4) << frame::plan.offsets[I] << " width " << frame::widths[I] << "\n"), ...);
+}
+
+int main() {
+  using mapping = member_mapping<em510_packed, config::ey_em510fxx>;
+  print_plan<mapping>(mapping::mappings{});
+
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{20};
+  cfg.relay_27.pulse_duration = std::chrono::milliseconds{255};
+  cfg.triac_03.polarity = true;
+  cfg.ai_23 = true;
+  cfg.ao_11 = 200;
+  cfg.relay_27.safety_value = true;
+  cfg.slc_timeout = std::chrono::seconds{600};
+  cfg.deadtime_timeout = std::chrono::duration<int, std::deci>{25};
+
+  em510_packed packed{};
+  update_all(packed, cfg);
+
+  config::ey_em510fxx decoded;
+  decoded.slc_timeout = decoded.powerup_timeout = std::chrono::seconds{0};
+  fill_all(packed, decoded);
+
+  assert(decoded.triac_01.pulse_duration == cfg.triac_01.pulse_duration);
+  assert(decoded.relay_27.pulse_duration == cfg.relay_27.pulse_duration);
+  assert(decoded.triac_03.polarity && !decoded.triac_01.polarity);
+  assert(decoded.ai_23 && !decoded.ai_22);
+  assert(decoded.ao_11 == 200);
+  assert(decoded.relay_27.safety_value && !decoded.relay_26.safety_value);
+  assert(decoded.slc_timeout == cfg.slc_timeout);
+  assert(decoded.deadtime_timeout == cfg.deadtime_timeout);
+  assert(decoded.powerup_timeout == cfg.powerup_timeout);
+
+  std::cout << "hand written layout : " << sizeof(em510_binary_representation) << " bytes without the timeouts, "
+            << "packed layout : " << em510_packed::size << " bytes with them" << std::endl;
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <fstream>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/profile_map.hpp>
+
+#include "./em510_binary.hpp"
+
+
+/*
+ * Profiling a gateway
+ *
+ * Built as profile_map_profiled, with -DANNOTATE_PROFILE and -rdynamic :
+ *
+ *   perf record ./profile_map_profiled 50000000
+ *   perf report --sort symbol
+ *
+ * shows fill_run<..., 0ul> and fill_field<..., 6ul> apart, and the perf map written next to the samples tells
+ * which fields run 0 and field 6 are ; perf script gives addresses which symbol_at joins back to the fields.
+ */
+
+int main(int argc, char** argv) {
+  const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+
+  const size_t window = 4096;
+  std::vector<em510_binary_representation> frames(window);
+  for (size_t k = 0; k < window; ++k) {
+    config::ey_em510fxx cfg;
+    cfg.triac_01.polarity = k & 1;
+    cfg.ao_09 = static_cast<uint8_t>(k);
+    cfg.relay_27.pulse_duration = std::chrono::milliseconds{ k % 256 };
+    std::memset(&frames[k], 0, sizeof(em510_binary_representation));
+    update_all(frames[k], cfg);
+  }
+
+  std::vector<config::ey_em510fxx> decoded(window);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) { fill_all(frames[k % window], decoded[k % window]); }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  assert(decoded[1].triac_01.polarity && decoded[window - 1].ao_09 == uint8_t(window - 1));
+
+  const auto symbols = codec_symbols<em510_binary_representation, config::ey_em510fxx>();
+
+  // The struct, the runs of bytes copied as they are, and the bitfields, converted one by one.
+  using plan = copy_plan<em510_binary_representation, config::ey_em510fxx>;
+  static_assert(plan::runs.count == 1, "the analog values, the other fields change type or are bitfields");
+  assert(symbols.size() == 2 + 2 * plan::runs.count + 2 * (6 + 6 + 4 + 6));
+  assert(symbols[2].entry == "fill_run" && symbols[2].fields.size() == 3 && symbols[2].fields[1] == "ao_09");
+  assert(symbols[0].entry == "fill_all" && symbols[0].fields.size() == 25);
+  assert(symbols[0].codec == "em510_binary_representation");
+
+  const auto polarity = std::find_if(symbols.begin(), symbols.end(), [](const codec_symbol& s) {
+    return s.entry == "fill_field" && s.fields.front() == "triac_01.polarity";
+  });
+  assert(polarity != symbols.end() && polarity->sources.front() == "bo_polarities.triac_01");
+
+  // Profiled and exported, every entry point has its own range : any address in one of them is one of its fields.
+  const bool ranges = std::all_of(symbols.begin(), symbols.end(), [](const codec_symbol& s) { return s.size; });
+  if (profile_enabled && ranges) {
+    for (const auto& s : symbols) {
+      assert(symbol_at(symbols, s.start + s.size - 1) == &s);
+      assert(s.symbol.find("fill_") != std::string::npos || s.symbol.find("update_") != std::string::npos);
+    }
+    assert(symbol_at(symbols, polarity->start + polarity->size / 2)->sources.front() == "bo_polarities.triac_01");
+  }
+
+  write_symbol_json(std::cout, symbols);
+  if (profile_enabled && ranges) {
+    std::ofstream perf_map(perf_map_path());
+    write_perf_map(perf_map, symbols);
+  }
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << count << " decodes, " << std::chrono::duration_cast<ns>(elapsed).count() / double(count)
+            << " ns per decode, "
+            << ((profile_enabled && ranges) ? "code ranges in " + perf_map_path()
+                                            : std::string("not profiled, see profile_map_profiled")) << std::endl;
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdlib>
+#include <cassert>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <system_error>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/flat_record.hpp>
+#include <annotate/shm_ring.hpp>
+
+#include "./em510_binary.hpp"
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+
+using em510_record = flat_record<em510_binary_representation, config::ey_em510fxx>;
+
+/**
+ * Every mapped field of record k is derived from k (modulo what ao_07 and ao_11 can hold), a torn read would mix
+ * two records.
+ */
+config::ey_em510fxx config_number(uint64_t k) {
+  k %= 65536;
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{k % 256};
+  cfg.relay_27.polarity = (k % 2) == 1;
+  cfg.ai_22 = (k % 3) == 1;
+  cfg.ao_07 = static_cast<uint8_t>(k);
+  cfg.ao_11 = static_cast<uint8_t>(k >> 8);
+  return cfg;
+}
+
+bool is_consistent(const config::ey_em510fxx& cfg) {
+  const uint64_t k = cfg.ao_07 | (uint64_t{cfg.ao_11} << 8);
+  const auto expected = config_number(k);
+  return cfg.triac_01.pulse_duration == expected.triac_01.pulse_duration &&
+         cfg.relay_27.polarity == expected.relay_27.polarity && cfg.ai_22 == expected.ai_22;
+}
+
+int main(int argc, char** argv) {
+
+  static_assert(em510_record::layout::size == 6 * 8 + 19, "6 durations and 19 bytes");
+  static_assert(sizeof(em510_record) == em510_record::layout::size, "flat records have no padding");
+
+  std::cout << c_header<em510_binary_representation, config::ey_em510fxx>("em510_record");
+
+  const std::string name = "/annotate-em510-" + std::to_string(::getpid());
+  auto writer = shm_ring<em510_record>::create(name, 64);
+
+  constexpr uint64_t records = 200000;
+
+  pid_t reader = ::fork();
+  if (reader == 0) {
+    // Another process : its own mapping, it only shares the name.
+    auto ring = shm_ring<em510_record>::open(name);
+    em510_record record;
+    uint64_t reads = 0;
+    uint64_t published;
+    do {
+      published = ring.published();
+      if (ring.read_latest(record)) {
+        config::ey_em510fxx cfg;
+        record.to(cfg);
+        if (!is_consistent(cfg)) { ::_exit(1); }
+        ++reads;
+      }
+    } while (published < records);
+    ::_exit(reads > 0 ? 0 : 2);
+  }
+
+  for (uint64_t k = 0; k < records; ++k) {
+    writer.publish(em510_record::of(config_number(k)));
+  }
+
+  int status = 0;
+  ::waitpid(reader, &status, 0);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // Older records stay readable until the ring wraps.
+  em510_record record;
+  assert(writer.read(records - 1, record));
+  assert(writer.read(records - 64, record));
+  assert(!writer.read(records - 65, record));
+  config::ey_em510fxx cfg;
+  record.to(cfg);
+  assert(cfg.ao_07 == static_cast<uint8_t>(records - 64));
+
+  shm_ring<em510_record>::unlink(name);
+
+  // A ring needs a slot to publish into.
+  try {
+    shm_ring<em510_record>::create(name, 0);
+    assert(false);
+  } catch (const std::system_error& e) {
+    assert(e.code().value() == EINVAL);
+  }
+
+  std::cout << "published " << records << " records, read back consistent from another process" << std::endl;
+  return 0;
+}
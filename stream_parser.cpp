@@ -0,0 +1,100 @@
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/stream_parser.hpp>
+
+#include "./em510_binary.hpp"
+
+config::ey_em510fxx frame_config(size_t k) {
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{k % 256};
+  cfg.relay_27.pulse_duration = std::chrono::milliseconds{(k / 256) % 256};
+  cfg.triac_03.polarity = (k & 1) != 0;
+  cfg.ai_22 = (k & 2) != 0;
+  cfg.ao_09 = static_cast<uint8_t>(k * 7);
+  cfg.relay_25.safety_value = (k & 4) != 0;
+  return cfg;
+}
+
+bool same_frame(const config::ey_em510fxx& a, const config::ey_em510fxx& b) {
+  return a.triac_01.pulse_duration == b.triac_01.pulse_duration &&
+    a.relay_27.pulse_duration == b.relay_27.pulse_duration &&
+    a.triac_03.polarity == b.triac_03.polarity && a.ai_22 == b.ai_22 && a.ao_09 == b.ao_09 &&
+    a.relay_25.safety_value == b.relay_25.safety_value;
+}
+
+template <class Parser, size_t... I>
+void print_schedule(double byte_ms, std::index_sequence<I...>) {
+  const auto& s = Parser::schedule();
+  auto needs = [&](size_t field) {
+    return s.needs[std::find(s.order.begin(), s.order.end(), field) - s.order.begin()];
+  };
+  ((std::cout << std::setw(24) << std::left << Parser::mapping::dest_name(std::integral_constant<size_t, I>{})
+              << " after " << needs(I) << " bytes, " << needs(I) * byte_ms << "ms\n"), ...);
+}
+
+int main(int argc, char** argv) {
+  using parser = stream_parser<em510_binary_representation, config::ey_em510fxx>;
+  using mapping = parser::mapping;
+
+  const size_t frames = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  // At 9600 bauds, 8N1, a byte takes 1.04ms : each field is decoded as soon as its last byte arrived.
+  const double byte_ms = 10.0 / 9600 * 1000;
+  std::cout << std::fixed << std::setprecision(2) << "whole frame after " << parser::frame_size * byte_ms << "ms\n";
+  print_schedule<parser>(byte_ms, mapping::mappings{});
+
+  std::vector<uint8_t> stream(frames * parser::frame_size);
+  for (size_t k = 0; k < frames; ++k) {
+    em510_binary_representation bin{};
+    update_all(bin, frame_config(k));
+    std::memcpy(stream.data() + k * parser::frame_size, &bin, parser::frame_size);
+  }
+
+  // Chunks of 1 to 40 bytes, as a serial driver hands them over.
+  std::mt19937 random(42);
+  std::vector<size_t> chunks;
+  for (size_t at = 0; at < stream.size();) {
+    const size_t chunk = std::min<size_t>(1 + random() % 40, stream.size() - at);
+    chunks.push_back(chunk);
+    at += chunk;
+  }
+
+  parser p;
+  size_t records = 0;
+  auto start = std::chrono::steady_clock::now();
+  const uint8_t* at = stream.data();
+  for (size_t chunk : chunks) {
+    p.feed(at, chunk, [&](const config::ey_em510fxx& cfg) {
+      assert(same_frame(cfg, frame_config(records)));
+      ++records;
+    });
+    at += chunk;
+  }
+  auto fragmented = std::chrono::steady_clock::now() - start;
+  assert(records == frames && p.received() == 0);
+
+  // Byte by byte, the first field is there before the frame.
+  parser slow;
+  for (size_t b = 0; b < parser::frame_size - 1; ++b) {
+    assert(slow.feed(stream.data() + parser::frame_size + b, 1, [](const config::ey_em510fxx&) {}) == 0);
+  }
+  assert(slow.fields_ready() > 0 && slow.fields_ready() < parser::fields);
+  assert(slow.partial().triac_01.pulse_duration == frame_config(1).triac_01.pulse_duration);
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << frames << " frames in " << chunks.size() << " chunks : "
+            << std::chrono::duration_cast<ns>(fragmented).count() / double(frames) << " ns per frame" << std::endl;
+  return 0;
+}
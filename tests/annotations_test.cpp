@@ -0,0 +1,61 @@
+#include <cassert>
+#include <cstdint>
+#include <chrono>
+#include <tuple>
+#include <annotate/literals.hpp>
+#include <annotate/annotations.hpp>
+#include <boost/mpl/size.hpp>
+
+namespace config {
+
+  struct channel {
+    std::chrono::milliseconds pulse_duration{0};
+    bool polarity{};
+  };
+
+  struct module {
+    channel triac_01{};
+    channel triac_03{};
+  };
+
+}
+
+struct module_binary_representation {
+  annotated(triac_01_pulse_duration, polarities.triac_03)
+
+  uint8_t 📃(triac_01_pulse_duration); 📒(annotate_mapv3(config::module, triac_01.pulse_duration), jsonize{})
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 6_bits;
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+  } polarities;
+
+  📜(polarities.triac_03, annotate_map(polarities.triac_03, config::module, triac_03.polarity))
+};
+
+static_assert(boost::mpl::size<module_binary_representation::annotated>::value == 3, "bool placeholder and 2 fields");
+
+int main() {
+  module_binary_representation bin{};
+  config::module cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{120};
+  cfg.triac_03.polarity = true;
+
+  auto pulse = bin.get_annotations(BOOST_METAPARSE_STRING("triac_01_pulse_duration"){});
+  auto polarity = bin.get_annotations(BOOST_METAPARSE_STRING("polarities.triac_03"){});
+  static_assert(std::tuple_size<decltype(pulse)>::value == 3, "placeholder, mapping and jsonize");
+  static_assert(is_annotation_map<std::decay_t<decltype(std::get<1>(polarity))>>::value, "annotate_map");
+
+  std::get<1>(pulse).fill_src(bin, cfg);
+  std::get<1>(polarity).fill_src(bin, cfg);
+  assert(bin.triac_01_pulse_duration == 120 && bin.polarities.triac_03);
+  assert(std::get<1>(pulse).bytes == sizeof(std::chrono::milliseconds));
+
+  config::module decoded;
+  std::get<1>(pulse).fill_dst(bin, decoded);
+  std::get<1>(polarity).fill_dst(bin, decoded);
+  assert(decoded.triac_01.pulse_duration == cfg.triac_01.pulse_duration && decoded.triac_03.polarity);
+
+  return 0;
+}
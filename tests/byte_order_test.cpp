@@ -0,0 +1,111 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <boost/endian/buffers.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/byte_order.hpp>
+
+using namespace boost::endian;
+
+namespace config {
+
+  struct status {
+    uint16_t a{}, b{}, c{}, d{}, e{}, f{}, g{}, h{}, i{};
+    uint32_t counter{};
+    int8_t offset{};
+    std::chrono::milliseconds delay{0};
+  };
+
+}
+
+struct status_frame {
+  big_uint16_buf_t a, b, c, d, e, f, g, h, i;
+  big_uint32_buf_t counter;
+  big_int8_buf_t offset;
+  big_uint16_buf_t delay;
+};
+
+map_to(status_frame, config::status,
+  ((a, a)) ((b, b)) ((c, c)) ((d, d)) ((e, e)) ((f, f)) ((g, g)) ((h, h)) ((i, i))
+  ((counter, counter))
+  ((offset, offset))
+  ((delay, delay))
+);
+
+struct swapped_frame {
+  big_uint16_buf_t a, b;
+  big_uint8_buf_t offset;
+};
+
+map_to(swapped_frame, config::status,
+  ((a, a)) ((b, b))
+  ((offset, offset))
+);
+
+struct native_frame {
+  uint16_t a;
+  uint16_t b;
+};
+
+map_to(native_frame, config::status,
+  ((a, a)) ((b, b))
+);
+
+using status_plan = copy_plan<status_frame, config::status>;
+
+static_assert(byte_mapping<big_uint8_buf_t, uint8_t>::kind == copy_kind::identity, "a single byte");
+static_assert(byte_mapping<big_int8_buf_t, uint8_t>::kind == copy_kind::identity, "same bits");
+static_assert(byte_mapping<big_uint16_buf_t, bool>::kind == copy_kind::transform, "not a bool");
+static_assert(byte_mapping<big_uint16_buf_t, std::chrono::milliseconds>::kind == copy_kind::transform, "");
+static_assert(byte_mapping<big_int24_buf_t, int32_t>::kind == copy_kind::transform, "a different size");
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+static_assert(byte_mapping<big_uint32_buf_t, uint32_t>::kind == copy_kind::swap, "");
+static_assert(byte_mapping<little_uint32_buf_t, uint32_t>::kind == copy_kind::identity, "");
+
+static_assert(status_plan::layout == frame_class::mixed, "delay changes type");
+static_assert(status_plan::runs.count == 3, "the 16 bits, the 32 bits, the offset");
+static_assert(status_plan::runs.runs[0].kind == copy_kind::swap && status_plan::runs.runs[0].size == 18, "");
+static_assert(status_plan::runs.runs[1].element == 4, "");
+static_assert(copy_plan<swapped_frame, config::status>::layout == frame_class::swapped, "");
+#endif
+static_assert(copy_plan<native_frame, config::status>::layout == frame_class::native, "");
+
+int main() {
+  // swap_copy through pshufb and its tail.
+  {
+    char in[20], out[20];
+    for (int b = 0; b < 20; ++b) { in[b] = static_cast<char>(b); }
+    swap_copy<4, 20>(out, in);
+    for (int b = 0; b < 20; ++b) { assert(out[b] == in[b / 4 * 4 + 3 - b % 4]); }
+    swap_copy<2, 18>(out, in);
+    for (int b = 0; b < 18; ++b) { assert(out[b] == in[b / 2 * 2 + 1 - b % 2]); }
+    swap_copy<8, 16>(out, in);
+    for (int b = 0; b < 16; ++b) { assert(out[b] == in[b / 8 * 8 + 7 - b % 8]); }
+  }
+
+  config::status s;
+  s.a = 0x0102;
+  s.e = 0xA0B0;
+  s.i = 0xFFFE;
+  s.counter = 0x11223344;
+  s.offset = -5;
+  s.delay = std::chrono::milliseconds{1500};
+
+  status_frame planned, by_field;
+  std::memset(&planned, 0, sizeof(planned));
+  std::memset(&by_field, 0, sizeof(by_field));
+  update_all(planned, s);
+  update_all(by_field, s, member_mapping<status_frame, config::status>::mappings{});
+  assert(std::memcmp(&planned, &by_field, sizeof(status_frame)) == 0);
+
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&planned);
+  assert(bytes[0] == 0x01 && bytes[1] == 0x02 && bytes[18] == 0x11 && bytes[21] == 0x44);
+
+  config::status back;
+  fill_all(planned, back);
+  assert(back.a == s.a && back.e == s.e && back.i == s.i && back.counter == s.counter);
+  assert(back.offset == -5 && back.delay == s.delay);
+
+  return 0;
+}
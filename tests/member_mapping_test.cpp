@@ -0,0 +1,198 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+
+namespace config {
+
+  struct channel {
+    std::chrono::milliseconds pulse_duration{0};
+    bool polarity{};
+  };
+
+  struct module {
+    channel triac_01{};
+    channel triac_03{};
+    uint8_t ao_07{};
+    std::array<bool, 16> inputs{};
+    std::array<channel, 8> relays{};
+  };
+
+  struct base_limits {
+    uint16_t low{};
+  };
+
+  struct limits : base_limits {
+    uint16_t high{};
+    uint16_t hysteresis{};
+    std::chrono::seconds delay{0};
+    std::array<uint8_t, 4> levels{};
+  };
+
+  struct reading {
+    int32_t value{};
+    uint32_t raw{};
+  };
+
+}
+
+struct module_binary_representation {
+  uint8_t triac_01_pulse_duration;
+  uint8_t triac_03_pulse_duration;
+
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 6_bits;
+    bool triac_01                             : 1_bits;
+    bool triac_03                             : 1_bits;
+  } polarities;
+
+  uint8_t ao_07_safety_value;
+  bit_column<16> inputs;
+  std::array<uint8_t, 8> relay_pulse_durations;
+  bit_column<8> relay_polarities;
+};
+
+map_to(module_binary_representation, config::module,
+  ((triac_01_pulse_duration, triac_01.pulse_duration))
+  ((triac_03_pulse_duration, triac_03.pulse_duration))
+  ((polarities.triac_01, triac_01.polarity))
+  ((polarities.triac_03, triac_03.polarity))
+  ((ao_07_safety_value, ao_07))
+  ((inputs, inputs))
+  ((relay_pulse_durations, relays, pulse_duration))
+  ((relay_polarities, relays, polarity))
+);
+
+using mapping = member_mapping<module_binary_representation, config::module>;
+
+struct limits_binary_representation {
+  uint16_t low;
+  uint16_t high;
+  uint16_t hysteresis;
+  uint8_t delay;
+  uint8_t reserved;
+  std::array<uint8_t, 4> levels;
+};
+
+map_to(limits_binary_representation, config::limits,
+  ((high, high))
+  ((delay, delay))
+  ((low, low))
+  ((levels, levels))
+  ((hysteresis, hysteresis))
+);
+
+/**
+ * Offset binary : the wire holds the value plus 2^31, through a caster of its own.
+ */
+template <>
+struct wire_caster<int32_t, uint32_t> {
+  static int32_t cast(uint32_t v) { return static_cast<int32_t>(v - 0x80000000u); }
+};
+
+template <>
+struct wire_caster<uint32_t, int32_t> {
+  static uint32_t cast(int32_t v) { return static_cast<uint32_t>(v) + 0x80000000u; }
+};
+
+struct reading_binary_representation {
+  uint32_t value;
+  uint32_t raw;
+};
+
+map_to(reading_binary_representation, config::reading,
+  ((value, value))
+  ((raw, raw))
+);
+
+template <size_t I>
+using anchor = std::integral_constant<size_t, I>;
+
+static_assert(mapping::value, "map_to specializes member_mapping");
+static_assert(!member_mapping<config::module, module_binary_representation>::value, "mappings are directed");
+static_assert(mapping::mappings::size() == 8, "one anchor per mapping");
+static_assert(sizeof(module_binary_representation) == 15, "packed as declared");
+
+// Only ao_07 is copied unchanged : pulse durations change type, polarities are bitfields.
+static_assert(copy_plan<module_binary_representation, config::module>::runs.count == 1, "ao_07");
+static_assert(copy_plan<module_binary_representation, config::module>::runs.runs[0].size == 1, "ao_07");
+static_assert(copy_plan<module_binary_representation, config::module>::spans[2].kind == copy_kind::transform, "a bitfield");
+
+// low (in the base), high and hysteresis are contiguous on both sides whatever the mapping order, levels is
+// after the delay.
+using limits_plan = copy_plan<limits_binary_representation, config::limits>;
+static_assert(limits_plan::runs.count == 2, "two runs");
+static_assert(limits_plan::runs.runs[0].src == 0 && limits_plan::runs.runs[0].size == 6, "low, high, hysteresis");
+static_assert(limits_plan::runs.runs[1].src == 8 && limits_plan::runs.runs[1].size == 4, "levels");
+static_assert(limits_plan::spans[1].kind == copy_kind::transform, "delay changes type");
+
+// Integrals of the same size with a caster of their own go through it.
+using reading_plan = copy_plan<reading_binary_representation, config::reading>;
+static_assert(reading_plan::spans[0].kind == copy_kind::transform, "offset binary");
+static_assert(reading_plan::runs.count == 1 && reading_plan::runs.runs[0].src == 4, "raw");
+
+int main() {
+  assert(std::strcmp(mapping::dest_name(anchor<0>{}), "triac_01.pulse_duration") == 0);
+  assert(std::strcmp(mapping::dest_name(anchor<4>{}), "ao_07") == 0);
+
+  config::module cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{20};
+  cfg.triac_03.polarity = true;
+  cfg.ao_07 = 42;
+  cfg.inputs[3] = cfg.inputs[15] = true;
+  cfg.relays[2].pulse_duration = std::chrono::milliseconds{255};
+  cfg.relays[7].polarity = true;
+
+  module_binary_representation bin{};
+  update_all(bin, cfg);
+  assert(bin.triac_01_pulse_duration == 20 && bin.polarities.triac_03 && !bin.polarities.triac_01);
+  assert(bin.inputs.bits[0] == 0x08 && bin.inputs.bits[1] == 0x80);
+  assert(bin.relay_pulse_durations[2] == 255 && bin.relay_polarities.bits[0] == 0x80);
+
+  config::module decoded;
+  fill_all(bin, decoded);
+  assert(decoded.triac_01.pulse_duration == cfg.triac_01.pulse_duration);
+  assert(decoded.triac_03.polarity && decoded.ao_07 == 42);
+  assert(decoded.inputs == cfg.inputs);
+  assert(decoded.relays[2].pulse_duration == cfg.relays[2].pulse_duration && decoded.relays[7].polarity);
+
+  // A single field, through its anchor.
+  config::module one;
+  mapping::fill(anchor<4>{}, bin, one);
+  assert(one.ao_07 == 42 && one.triac_01.pulse_duration.count() == 0);
+  assert(mapping::dest_value(anchor<0>{}, cfg) == std::chrono::milliseconds{20});
+  mapping::dest_field(anchor<4>{}, one) = 7;
+  assert(one.ao_07 == 7);
+
+  // Runs and per field code together.
+  config::limits l;
+  l.low = 100;
+  l.high = 900;
+  l.hysteresis = 25;
+  l.delay = std::chrono::seconds{30};
+  l.levels = {{ 1, 2, 3, 4 }};
+
+  limits_binary_representation lb{};
+  update_all(lb, l);
+  assert(lb.low == 100 && lb.high == 900 && lb.hysteresis == 25 && lb.delay == 30 && lb.levels[3] == 4);
+
+  config::limits back;
+  fill_all(lb, back);
+  assert(back.low == 100 && back.high == 900 && back.hysteresis == 25);
+  assert(back.delay == std::chrono::seconds{30} && back.levels == l.levels);
+
+  config::reading r;
+  r.value = -5;
+  r.raw = 7;
+  reading_binary_representation rb{};
+  update_all(rb, r);
+  assert(rb.value == 0x7FFFFFFBu && rb.raw == 7);
+  config::reading rback;
+  fill_all(rb, rback);
+  assert(rback.value == -5 && rback.raw == 7);
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cstdint>
+#include <chrono>
+#include <annotate/member_mapping.hpp>
+#include <annotate/modbus.hpp>
+
+namespace config {
+
+  enum class mode : uint8_t { off, on, automatic };
+
+  struct drive {
+    uint16_t speed{};
+    uint32_t position{};
+    mode state{};
+    int8_t offset{};
+    std::chrono::milliseconds ramp{0};
+    bool enabled{}, reversed{}, locked{};
+  };
+
+}
+
+modbus_map(drive_registers, config::drive,
+  ((speed))
+  ((position))
+  ((state))
+  ((offset))
+  ((ramp, 2)),
+
+  ((enabled))
+  ((reversed))
+  ((locked))
+);
+
+static_assert(drive_registers::holding_registers == 7, "speed, position on two, state, offset, ramp on two");
+static_assert(drive_registers::plan.addresses[4] == 5, "ramp");
+static_assert(drive_registers::coils == 3 && sizeof(drive_registers::coil_bits) == 1, "one byte of coils");
+
+using fields = modbus::fields<drive_registers>;
+
+int main() {
+  // Bits copied at any offset, LSB first.
+  {
+    const uint8_t bits[3] = { 0b10110000, 0b01011101, 0b00000011 };
+    uint8_t out[2] = {};
+    modbus::extract_bits(bits, sizeof(bits), 4, 10, out);
+    assert(out[0] == 0b11011011 && out[1] == 0b00000001);
+
+    uint8_t back[3] = { 0xFF, 0x00, 0xFF };
+    modbus::insert_bits(out, 10, back, 4);
+    assert(back[0] == 0b10111111 && back[1] == 0b00011101 && back[2] == 0xFF);
+  }
+
+  // Plans : the fields a range touches, and those it holds whole.
+  {
+    modbus::range_plan plan;
+    assert(fields::plan_registers(0, 7, plan));
+    assert(plan.first_field == 0 && plan.end_field == 5 && plan.first_whole == 0 && plan.end_whole == 5);
+
+    assert(fields::plan_registers(2, 3, plan));
+    assert(plan.first_field == 1 && plan.end_field == 4 && plan.first_whole == 2 && plan.end_whole == 4);
+
+    assert(fields::plan_registers(6, 1, plan));
+    assert(plan.first_field == 4 && plan.end_field == 5 && plan.first_whole == plan.end_whole);
+
+    assert(!fields::plan_registers(6, 2, plan));
+    assert(!fields::plan_registers(0, 0, plan));
+
+    assert(fields::plan_coils(1, 2, plan));
+    assert(plan.first_field == 6 && plan.end_field == 8);
+    assert(!fields::plan_coils(2, 2, plan));
+  }
+
+  config::drive d;
+  d.speed = 0x1234;
+  d.position = 0xDEADBEEF;
+  d.state = config::mode::automatic;
+  d.offset = -3;
+  d.ramp = std::chrono::milliseconds{70000};
+  d.reversed = true;
+  d.locked = true;
+
+  modbus::fake_slave<drive_registers> slave(d);
+  uint8_t response[modbus::max_pdu_size + 1];
+
+  // Registers big endian, multi-register values high word first.
+  {
+    const uint8_t request[] = { modbus::read_holding_registers, 0, 0, 0, 7 };
+    assert(slave.handle(request, sizeof(request), response) == 16);
+    const uint8_t expected[] = { 0x03, 14, 0x12, 0x34, 0xDE, 0xAD, 0xBE, 0xEF, 0x00, 0x02, 0xFF, 0xFD,
+                                 0x00, 0x01, 0x11, 0x70 };
+    for (size_t i = 0; i < sizeof(expected); ++i) { assert(response[i] == expected[i]); }
+  }
+
+  {
+    const uint8_t request[] = { modbus::read_coils, 0, 0, 0, 3 };
+    assert(slave.handle(request, sizeof(request), response) == 3);
+    assert(response[1] == 1 && response[2] == 0b110);
+  }
+
+  // Writes decode the fields they hold whole.
+  {
+    const uint8_t request[] = { modbus::write_multiple_registers, 0, 3, 0, 2, 4, 0x00, 0x01, 0x00, 0x7F };
+    assert(slave.handle(request, sizeof(request), response) == 5);
+    assert(response[0] == modbus::write_multiple_registers && response[4] == 2);
+    assert(slave.config().state == config::mode::on && slave.config().offset == 127);
+    assert(slave.config().position == 0xDEADBEEF);
+
+    const uint8_t coils[] = { modbus::write_multiple_coils, 0, 0, 0, 2, 1, 0b01 };
+    assert(slave.handle(coils, sizeof(coils), response) == 5);
+    assert(slave.config().enabled && !slave.config().reversed && slave.config().locked);
+  }
+
+  // Exceptions.
+  {
+    const uint8_t beyond[] = { modbus::read_holding_registers, 0, 6, 0, 2 };
+    assert(slave.handle(beyond, sizeof(beyond), response) == 2);
+    assert(response[0] == 0x83 && response[1] == uint8_t(modbus::exception::illegal_data_address));
+
+    const uint8_t too_many[] = { modbus::read_holding_registers, 0, 0, 0, 126 };
+    slave.handle(too_many, sizeof(too_many), response);
+    assert(response[1] == uint8_t(modbus::exception::illegal_data_value));
+
+    const uint8_t short_write[] = { modbus::write_multiple_registers, 0, 0, 0, 2, 4, 0x00 };
+    slave.handle(short_write, sizeof(short_write), response);
+    assert(response[1] == uint8_t(modbus::exception::illegal_data_value));
+
+    const uint8_t unknown[] = { 0x2B, 0, 0, 0, 1 };
+    slave.handle(unknown, sizeof(unknown), response);
+    assert(response[0] == 0xAB && response[1] == uint8_t(modbus::exception::illegal_function));
+  }
+
+  // A master round trip.
+  {
+    modbus::fake_slave<drive_registers> device;
+    modbus::master<drive_registers> master(
+      [&](const uint8_t* request, size_t size, uint8_t* out) { return device.handle(request, size, out); });
+    assert(master.write(d) == modbus::exception::none);
+    assert(device.requests() == 2);
+
+    config::drive back;
+    assert(master.read(back) == modbus::exception::none);
+    assert(back.speed == d.speed && back.position == d.position && back.state == d.state);
+    assert(back.offset == d.offset && back.ramp == d.ramp);
+    assert(!back.enabled && back.reversed && back.locked);
+  }
+
+  return 0;
+}
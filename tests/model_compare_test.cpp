@@ -0,0 +1,168 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <map>
+#include <new>
+#include <unordered_map>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/packed_layout.hpp>
+#include <annotate/model_compare.hpp>
+
+namespace config {
+
+  struct channel {
+    std::chrono::milliseconds pulse{0};
+    bool polarity{};
+  };
+
+  struct device {
+    uint8_t level{};
+    uint32_t count{};
+    channel a{};
+    float gain{1};
+    std::array<uint16_t, 3> limits{};
+    uint16_t unmapped{};
+  };
+
+  struct channel_bank {
+    std::array<channel, 8> channels{};
+    uint8_t level{};
+  };
+
+}
+
+struct device_frame {
+  uint8_t level;
+  uint16_t count;
+  uint8_t a_pulse;
+  struct alignas(1_byte) {
+    bool a                                    : 1_bits;
+    uint8_t reserved                          : 7_bits;
+  } polarities;
+  float gain;
+  std::array<uint16_t, 3> limits;
+};
+
+map_to(device_frame, config::device,
+  ((gain, gain))
+  ((count, count))
+  ((level, level))
+  ((a_pulse, a.pulse))
+  ((polarities.a, a.polarity))
+  ((limits, limits))
+);
+
+packed_layout(device_packed, config::device,
+  ((level))
+  ((unmapped, 16_bits))
+);
+
+struct channel_bank_frame {
+  std::array<uint8_t, 8> pulses;
+  bit_column<8> polarities;
+  uint8_t level;
+};
+
+map_to(channel_bank_frame, config::channel_bank,
+  ((pulses, channels, pulse))
+  ((polarities, channels, polarity))
+  ((level, level))
+);
+
+mapped_comparisons(device_frame, config::device)
+
+using fields = mapped_fields<device_frame, config::device>;
+using packed_fields = mapped_fields<device_packed, config::device>;
+using bank_fields = mapped_fields<channel_bank_frame, config::channel_bank>;
+
+// level | padding | count, a.pulse, a.polarity | padding | gain | limits : gain is a float, compared by value.
+static_assert(fields::plan.count == 4, "level, count to a, gain and limits");
+static_assert(fields::plan.order[0] == 2 && fields::plan.order[1] == 1 && fields::plan.order[5] == 5, "layout order");
+static_assert(fields::plan.runs[1].size == 13 && fields::plan.runs[1].end - fields::plan.runs[1].first == 3,
+              "count, pulse and polarity in one run");
+static_assert(!fields::plan.runs[2].bytewise, "float");
+static_assert(packed_fields::plan.count == 2, "level, unmapped");
+
+/**
+ * Padding bytes of a model are whatever the memory held.
+ */
+config::device* garbage_device(void* storage, uint8_t garbage) {
+  std::memset(storage, garbage, sizeof(config::device));
+  auto* d = new (storage) config::device;
+  std::memset(&d->a.polarity + 1, garbage, sizeof(config::channel) - offsetof(config::channel, polarity) - 1);
+  return d;
+}
+
+int main() {
+  alignas(config::device) unsigned char first[sizeof(config::device)];
+  alignas(config::device) unsigned char second[sizeof(config::device)];
+  config::device& a = *garbage_device(first, 0x00);
+  config::device& b = *garbage_device(second, 0xA5);
+  assert(std::memcmp(&a, &b, sizeof(config::device)) != 0);
+
+  // Padding and fields left out of the mapping do not count.
+  b.unmapped = 7;
+  assert(fields::equal(a, b) && fields::compare(a, b) == 0);
+  assert(std::hash<config::device>{}(a) == std::hash<config::device>{}(b));
+  assert(!packed_fields::equal(a, b));
+
+  // Each mapped field does.
+  b.a.polarity = true;
+  assert(!fields::equal(a, b) && fields::less(a, b) && !fields::less(b, a));
+  assert(std::hash<config::device>{}(a) != std::hash<config::device>{}(b));
+  b.a.polarity = false;
+  b.limits[2] = 1;
+  assert(!std::equal_to<config::device>{}(a, b));
+  b.limits[2] = 0;
+  b.gain = 2;
+  assert(!fields::equal(a, b) && fields::compare(a, b) < 0);
+  a.gain = -0.0f;
+  b.gain = 0.0f;
+  assert(fields::equal(a, b));
+
+  // Ordering is lexicographic in the layout of the model : level first, whatever the rest.
+  a.level = 1;
+  b.count = 1000;
+  assert(fields::compare(a, b) > 0 && std::less<config::device>{}(b, a));
+  b.level = 1;
+  assert(fields::compare(a, b) < 0);
+  a.count = 0x100000;
+  assert(fields::compare(a, b) > 0);
+
+  // Keys of the standard containers.
+  std::unordered_map<config::device, int> seen;
+  std::map<config::device, int> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    config::device d;
+    d.count = static_cast<uint32_t>(i % 100);
+    d.a.pulse = std::chrono::milliseconds{ i % 100 % 7 };
+    d.unmapped = static_cast<uint16_t>(i);
+    ++seen[d];
+    ++sorted[d];
+  }
+  assert(seen.size() == 100 && sorted.size() == 100);
+  assert(sorted.begin()->first.count == 0 && sorted.rbegin()->first.count == 99);
+
+  config::device key;
+  key.count = 42;
+  key.a.pulse = std::chrono::milliseconds{ 0 };
+  assert(seen.at(key) == 10);
+
+  // member_map_each columns are compared and hashed element by element.
+  config::channel_bank x, y;
+  assert(bank_fields::equal(x, y) && bank_fields::hash(x) == bank_fields::hash(y));
+  y.channels[3].pulse = std::chrono::milliseconds{ 9 };
+  assert(!bank_fields::equal(x, y) && bank_fields::less(x, y));
+  assert(bank_fields::hash(x) != bank_fields::hash(y));
+  x.channels[4].pulse = std::chrono::milliseconds{ 9 };
+  assert(bank_fields::compare(x, y) < 0 && bank_fields::hash(x) != bank_fields::hash(y));
+  x.channels[4].pulse = std::chrono::milliseconds{ 0 };
+  x.channels[3].pulse = std::chrono::milliseconds{ 9 };
+  y.channels[7].polarity = true;
+  assert(!bank_fields::equal(x, y) && bank_fields::compare(y, x) > 0);
+
+  return 0;
+}
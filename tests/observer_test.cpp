@@ -0,0 +1,129 @@
+#include <cassert>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/observer.hpp>
+
+namespace config {
+
+  struct input {
+    bool polarity{};
+  };
+
+  struct device {
+    uint8_t level{};
+    bool alarm{};
+    std::chrono::seconds period{0};
+    std::array<input, 8> inputs{};
+  };
+
+}
+
+struct device_binary_representation {
+  uint8_t level;
+  struct alignas(1_byte) {
+    bool alarm                                : 1_bits;
+    uint8_t reserved                          : 7_bits;
+  } flags;
+  uint8_t period;
+  bit_column<8> inputs;
+};
+
+map_to(device_binary_representation, config::device,
+  ((level, level))
+  ((flags.alarm, alarm))
+  ((period, period))
+  ((inputs, inputs, polarity))
+);
+
+using observer = field_observer<device_binary_representation, config::device, 2>;
+
+struct call {
+  uint32_t device;
+  observer::changes changed;
+};
+
+int main() {
+  assert(observer::field_index("level") == 0 && observer::field_index("period") == 2);
+  assert(observer::field_index("inputs") == observer::no_field && observer::field_index("nope") == observer::no_field);
+
+  observer obs;
+  config::device state;
+  device_binary_representation frame{};
+
+  // Without subscriber, a plain decode.
+  frame.level = 3;
+  assert(obs.decode(1, frame, state).none() && state.level == 3);
+
+  std::vector<call> a_calls, b_calls;
+  const size_t a = obs.subscribe({ "level", "alarm" }, [&](uint32_t device, const config::device& c,
+                                                          const observer::changes& changed) {
+    assert(c.level == frame.level);
+    a_calls.push_back({ device, changed });
+  });
+  obs.subscribe({ "alarm", "period" }, [&](uint32_t device, const config::device&, const observer::changes& changed) {
+    b_calls.push_back({ device, changed });
+  });
+  assert(obs.watched().size() == 3);
+
+  try {
+    obs.subscribe({ "level" }, nullptr);
+    assert(false);
+  } catch (const std::length_error&) {}
+  try {
+    obs.subscribe({ "levels" }, nullptr);
+    assert(false);
+  } catch (const std::invalid_argument&) {}
+
+  // One call per subscriber per decode, with its changed fields only.
+  frame.level = 4;
+  frame.flags.alarm = true;
+  const auto changed = obs.decode(7, frame, state);
+  assert(changed.count() == 2 && changed[0] && changed[1]);
+  assert(a_calls.size() == 1 && a_calls[0].device == 7 && a_calls[0].changed.count() == 2);
+  assert(b_calls.size() == 1 && b_calls[0].changed.count() == 1 && b_calls[0].changed[1]);
+
+  // Unchanged frame, unwatched field : nobody is called.
+  frame.inputs.bits[0] = 0xFF;
+  assert(obs.decode(7, frame, state).none() && state.inputs[7].polarity);
+  assert(a_calls.size() == 1 && b_calls.size() == 1);
+
+  frame.period = 60;
+  obs.decode(8, frame, state);
+  assert(a_calls.size() == 1 && b_calls.size() == 2 && b_calls[1].device == 8 && b_calls[1].changed[2]);
+
+  // Unsubscribed, level is no longer compared, the slot is free again.
+  obs.unsubscribe(a);
+  assert(obs.watched().size() == 2);
+  frame.level = 9;
+  assert(obs.decode(7, frame, state).none() && a_calls.size() == 1);
+  assert(obs.subscribe({ "level" }, [](uint32_t, const config::device&, const observer::changes&) {}) == a);
+
+  // A callback unsubscribing itself, and the next subscriber, while decode runs it.
+  observer once;
+  size_t first_calls = 0, second_calls = 0;
+  const std::vector<size_t> captured(100, 1);
+  size_t second = observer::no_field;
+  const size_t first = once.subscribe({ "level" }, [&, captured](uint32_t, const config::device&,
+                                                                const observer::changes&) {
+    once.unsubscribe(second);
+    once.unsubscribe(first);
+    first_calls += captured.size();
+  });
+  second = once.subscribe({ "level" }, [&](uint32_t, const config::device&, const observer::changes&) {
+    ++second_calls;
+  });
+  frame.level = 10;
+  once.decode(1, frame, state);
+  assert(first_calls == 100 && second_calls == 0 && once.watched().empty());
+  frame.level = 11;
+  once.decode(1, frame, state);
+  assert(first_calls == 100 && second_calls == 0);
+  assert(once.subscribe({ "level" }, [](uint32_t, const config::device&, const observer::changes&) {}) == first);
+
+  return 0;
+}
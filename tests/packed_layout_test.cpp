@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstdint>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/packed_layout.hpp>
+
+namespace config {
+
+  enum class mode : uint8_t { off, on, automatic };
+
+  struct sensor {
+    uint8_t id{};
+    uint32_t serial{};
+    uint8_t a{}, b{}, c{};
+    uint16_t threshold{};
+    mode state{};
+    bool enabled{};
+    uint64_t counter{};
+    std::chrono::milliseconds period{0};
+  };
+
+  struct probe {
+    int16_t temperature{};
+    int8_t offset{};
+    int32_t drift{};
+    uint8_t gain{};
+  };
+
+}
+
+packed_layout(sensor_packed, config::sensor,
+  ((id))
+  ((serial))
+  ((a, 3_bits))
+  ((b, 3_bits))
+  ((c, 3_bits))
+  ((threshold))
+  ((state, 2_bits))
+  ((enabled))
+  ((counter))
+  ((period, 12_bits))
+);
+
+packed_layout(probe_packed, config::probe,
+  ((temperature, 12_bits))
+  ((offset))
+  ((drift, 20_bits))
+  ((gain, 4_bits))
+);
+
+// Whole bytes by alignment : counter, serial, threshold, id. Then the others widest first : period, a, b, c,
+// state, enabled.
+static_assert(sensor_packed::plan.offsets[8] == 0, "counter");
+static_assert(sensor_packed::plan.offsets[1] == 64, "serial");
+static_assert(sensor_packed::plan.offsets[5] == 96, "threshold");
+static_assert(sensor_packed::plan.offsets[0] == 112, "id");
+static_assert(sensor_packed::plan.offsets[9] == 120, "period");
+static_assert(sensor_packed::plan.offsets[2] == 132, "a");
+static_assert(sensor_packed::plan.offsets[4] == 138, "c crosses a byte boundary");
+static_assert(sensor_packed::plan.offsets[7] == 143, "enabled");
+static_assert(sensor_packed::size == 18, "144 bits");
+
+constexpr auto odd = make_packed_plan<3>({{8, 24, 16}});
+static_assert(odd.offsets[2] == 0 && odd.offsets[1] == 16 && odd.offsets[0] == 40 && odd.bytes == 6,
+              "a 24 bits field is only byte aligned, it goes after the 16 bits one");
+
+int main() {
+  config::sensor s;
+  s.id = 0xAB;
+  s.serial = 0xDEADBEEF;
+  s.a = 5;
+  s.b = 2;
+  s.c = 7;
+  s.threshold = 0x1234;
+  s.state = config::mode::automatic;
+  s.enabled = true;
+  s.counter = 0x0123456789ABCDEFull;
+  s.period = std::chrono::milliseconds{4000};
+
+  sensor_packed packed{};
+  update_all(packed, s);
+  assert(packed.bytes[0] == 0xEF && packed.bytes[7] == 0x01);
+  assert(packed.bytes[14] == 0xAB);
+
+  config::sensor d;
+  fill_all(packed, d);
+  assert(d.id == s.id && d.serial == s.serial && d.threshold == s.threshold && d.counter == s.counter);
+  assert(d.a == 5 && d.b == 2 && d.c == 7);
+  assert(d.state == config::mode::automatic && d.enabled);
+  assert(d.period == s.period);
+
+  // Values wider than their field are cut, neighbours are untouched.
+  s.b = 0xFF;
+  update_all(packed, s);
+  fill_all(packed, d);
+  assert(d.b == 7 && d.a == 5 && d.c == 7);
+
+  // Signed fields come back sign extended from their width, unsigned ones as they are.
+  config::probe p;
+  p.temperature = -5;
+  p.offset = -128;
+  p.drift = -300000;
+  p.gain = 15;
+  probe_packed probe{};
+  update_all(probe, p);
+  config::probe q;
+  fill_all(probe, q);
+  assert(q.temperature == -5 && q.offset == -128 && q.drift == -300000 && q.gain == 15);
+
+  p.temperature = -2048;
+  p.drift = 524287;
+  update_all(probe, p);
+  fill_all(probe, q);
+  assert(q.temperature == -2048 && q.drift == 524287);
+  using probe_mapping = member_mapping<probe_packed, config::probe>;
+  assert((probe_mapping::decode_value(std::integral_constant<size_t, 0>{}, probe) == -2048));
+
+  return 0;
+}
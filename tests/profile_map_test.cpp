@@ -0,0 +1,102 @@
+#include <cassert>
+#include <cstdint>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/profile_map.hpp>
+
+namespace config {
+
+  struct input {
+    bool polarity{};
+  };
+
+  struct device {
+    uint16_t level{};
+    uint16_t limit{};
+    std::chrono::seconds period{0};
+    bool alarm{};
+    std::array<input, 8> inputs{};
+  };
+
+}
+
+struct device_frame {
+  uint16_t level;
+  uint16_t limit;
+  uint8_t period;
+  struct alignas(1_byte) {
+    bool alarm                                : 1_bits;
+    uint8_t reserved                          : 7_bits;
+  } flags;
+  bit_column<8> inputs;
+};
+
+map_to(device_frame, config::device,
+  ((level, level))
+  ((limit, limit))
+  ((period, period))
+  ((flags.alarm, alarm))
+  ((inputs, inputs, polarity))
+);
+
+int main() {
+  const auto symbols = codec_symbols<device_frame, config::device>();
+
+  // The struct, its one run and the three fields converted on their own.
+  assert(symbols.size() == 2 + 2 + 2 * 3);
+  assert(symbols[0].entry == "fill_all" && symbols[1].entry == "update_all");
+  assert(symbols[0].fields.size() == 5 && symbols[0].fields[4] == "column 4");
+  assert(symbols[2].entry == "fill_run" && symbols[3].entry == "update_run");
+  assert((symbols[2].fields == std::vector<std::string>{ "level", "limit" }));
+  assert((symbols[2].sources == std::vector<std::string>{ "level", "limit" }));
+  assert(symbols[6].entry == "fill_field" && symbols[6].fields[0] == "alarm" && symbols[6].sources[0] == "flags.alarm");
+  assert(symbols[8].fields[0] == "column 4" && symbols[8].sources.empty());
+  for (const auto& s : symbols) {
+    assert(s.codec == "device_frame" && s.start != 0);
+    assert(!s.symbol.empty());
+  }
+
+  // The entry points are the codec : calling them decodes.
+  device_frame frame{};
+  frame.level = 7;
+  frame.flags.alarm = true;
+  frame.inputs.bits[0] = 0x81;
+  config::device d;
+  fill_run<device_frame, config::device, 0>(frame, d);
+  fill_field<device_frame, config::device, 3>(frame, d);
+  assert(d.level == 7 && d.alarm && !d.inputs[0].polarity);
+  fill_all(frame, d);
+  assert(d.inputs[0].polarity && d.inputs[7].polarity && !d.inputs[1].polarity);
+
+  // Ranges and their formats.
+  std::vector<codec_symbol> ranges(2);
+  ranges[0].start = 0x1000;
+  ranges[0].size = 0x20;
+  ranges[0].codec = "device_frame";
+  ranges[0].entry = "fill_run";
+  ranges[0].fields = { "level", "limit" };
+  ranges[0].symbol = "fill_run<\"0\">";
+  ranges[1].start = 0x1020;
+  ranges[1].size = 0x10;
+  ranges[1].codec = "device_frame";
+  ranges[1].entry = "fill_field";
+  ranges[1].fields = { "alarm" };
+  ranges[1].sources = { "flags.alarm" };
+  assert(symbol_at(ranges, 0x101f) == &ranges[0] && symbol_at(ranges, 0x1020) == &ranges[1]);
+  assert(symbol_at(ranges, 0x1030) == nullptr);
+
+  std::ostringstream perf_map;
+  write_perf_map(perf_map, ranges);
+  assert(perf_map.str() == "1000 20 device_frame::fill_run level,limit\n1020 10 device_frame::fill_field alarm\n");
+
+  std::ostringstream json;
+  write_symbol_json(json, ranges);
+  assert(json.str().find("\"symbol\": \"fill_run<\\\"0\\\">\"") != std::string::npos);
+  assert(json.str().find("\"fields\": [\"alarm\"], \"sources\": [\"flags.alarm\"] }\n]") != std::string::npos);
+
+  return 0;
+}
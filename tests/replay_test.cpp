@@ -0,0 +1,102 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <system_error>
+#include <unistd.h>
+#include <annotate/frame_log.hpp>
+#include <annotate/replay.hpp>
+
+struct frame {
+  uint8_t level;
+  uint16_t count;
+};
+
+struct other_frame {
+  uint64_t count;
+};
+
+template <class Binary>
+int error_of(const std::string& path) {
+  try {
+    frame_log<Binary> log(path);
+  } catch (const std::system_error& e) {
+    return e.code().value();
+  }
+  return 0;
+}
+
+int main() {
+  // Exact below 32 ns, then within 1/16th.
+  latency_histogram h;
+  for (uint64_t ns : { 0, 1, 31 }) { assert(latency_histogram::upper_bound(latency_histogram::bucket_of(ns)) == ns); }
+  for (uint64_t ns : { 32ull, 33ull, 1000ull, 123456789ull, ~0ull }) {
+    const uint64_t bound = latency_histogram::upper_bound(latency_histogram::bucket_of(ns));
+    assert(bound >= ns && bound - ns <= ns / 16);
+  }
+  assert(latency_histogram::bucket_of(~0ull) == latency_histogram::buckets - 1);
+  for (uint64_t ns = 1; ns <= 1000; ++ns) { h.record(ns); }
+  assert(h.count() == 1000 && h.max() == 1000 && h.mean() == 500.5);
+  assert(h.percentile(0) == 1 && h.percentile(100) == 1000);
+  assert(h.percentile(50) >= 500 && h.percentile(50) <= 500 + 500 / 16);
+  assert(h.percentile(99.9) >= 999 && h.percentile(99.9) <= 1000);
+
+  latency_histogram tail;
+  tail.record(1000000);
+  h.merge(tail);
+  assert(h.count() == 1001 && h.max() == 1000000 && h.percentile(100) == 1000000 && h.percentile(50) <= 532);
+
+  // A log gives back the records as written.
+  const std::string path = "/tmp/replay_test-" + std::to_string(::getpid()) + ".log";
+  {
+    frame_log_writer<frame> writer(path);
+    for (uint16_t i = 0; i < 100; ++i) { writer.record(i % 4, frame{ static_cast<uint8_t>(i), i }, 1000 * i); }
+    writer.flush();
+    assert(writer.records() == 100);
+  }
+  {
+    frame_log<frame> log(path);
+    assert(log.size() == 100);
+    for (uint16_t i = 0; i < 100; ++i) {
+      const auto& r = log.records()[i];
+      assert(r.timestamp == 1000u * i && r.device == i % 4u && r.frame.level == i && r.frame.count == i);
+    }
+  }
+
+  // A record cut short is left out.
+  assert(::truncate(path.c_str(), sizeof(frame_log_header) + 99 * frame_log<frame>::record_size + 5) == 0);
+  assert(frame_log<frame>(path).size() == 99);
+
+  // Frames of another binary, or no log at all.
+  assert(error_of<other_frame>(path) == EPROTO);
+  {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("level,count\n", file);
+    std::fclose(file);
+  }
+  assert(error_of<frame>(path) == EPROTO);
+  std::remove(path.c_str());
+  assert(error_of<frame>(path) == ENOENT);
+
+  // Records come in order ; at recorded speed, not before their time.
+  struct record { uint64_t timestamp; int value; };
+  const std::vector<record> records{ { 5000000, 0 }, { 5000000, 1 }, { 6000000, 2 }, { 9000000, 3 } };
+  std::vector<int> seen;
+  const replay_report fast = replay(records.data(), records.size(), replay_speed::max,
+                                    [&](const record& r) { seen.push_back(r.value); });
+  assert((seen == std::vector<int>{ 0, 1, 2, 3 }) && fast.records == 4 && fast.latency.count() == 4);
+  assert(fast.elapsed < std::chrono::milliseconds(4));
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::chrono::steady_clock::duration> times;
+  const replay_report timed = replay(records.data(), records.size(), replay_speed::recorded,
+                                     [&](const record&) { times.push_back(std::chrono::steady_clock::now() - start); });
+  assert(times[2] >= std::chrono::milliseconds(1) && times[3] >= std::chrono::milliseconds(4));
+  assert(timed.elapsed >= std::chrono::milliseconds(4) && timed.latency.count() == 4);
+  assert(timed.throughput() > 0 && timed.throughput() < 1000);
+
+  return 0;
+}
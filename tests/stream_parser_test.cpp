@@ -0,0 +1,142 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/stream_parser.hpp>
+
+namespace config {
+
+  struct sensor {
+    uint8_t id{};
+    bool enabled{};
+    bool alarm{};
+    std::chrono::seconds period{0};
+    uint8_t level{};
+  };
+
+}
+
+struct sensor_binary_representation {
+  uint8_t level;
+  uint8_t id;
+  struct alignas(1_byte) {
+    uint8_t reserved                          : 6_bits;
+    bool enabled                              : 1_bits;
+    bool alarm                                : 1_bits;
+  } flags;
+  uint8_t period;
+};
+
+map_to(sensor_binary_representation, config::sensor,
+  ((period, period))
+  ((flags.alarm, alarm))
+  ((id, id))
+  ((flags.enabled, enabled))
+  ((level, level))
+);
+
+/**
+ * A word of alarm bits of which the model only keeps whether any is set.
+ */
+struct alarm_binary_representation {
+  uint8_t id;
+  uint16_t alarm_word;
+  uint8_t level;
+} __attribute__((packed));
+
+map_to(alarm_binary_representation, config::sensor,
+  ((alarm_word, alarm))
+  ((id, id))
+  ((level, level))
+);
+
+using parser = stream_parser<sensor_binary_representation, config::sensor>;
+using alarm_parser = stream_parser<alarm_binary_representation, config::sensor>;
+
+std::vector<uint8_t> frame(uint8_t id, bool enabled, bool alarm, uint8_t period, uint8_t level) {
+  return { level, id, static_cast<uint8_t>((enabled ? 0x40 : 0) | (alarm ? 0x80 : 0)), period };
+}
+
+int main() {
+  // Decoding order : by the last byte each field needs, then mapping order.
+  const auto& s = parser::schedule();
+  const size_t order[] = { 4, 2, 1, 3, 0 };
+  const size_t needs[] = { 1, 2, 3, 3, 4 };
+  for (size_t i = 0; i < parser::fields; ++i) { assert(s.order[i] == order[i] && s.needs[i] == needs[i]); }
+
+  std::vector<config::sensor> records;
+  auto on_record = [&](const config::sensor& c) { records.push_back(c); };
+
+  // Byte by byte, fields are decoded as their bytes arrive.
+  {
+    parser p;
+    const auto f = frame(7, true, false, 30, 200);
+    assert(p.feed(f.data(), 1, on_record) == 0 && p.fields_ready() == 1 && p.partial().level == 200);
+    assert(p.feed(f.data() + 1, 1, on_record) == 0 && p.fields_ready() == 2 && p.partial().id == 7);
+    assert(p.feed(f.data() + 2, 1, on_record) == 0 && p.fields_ready() == 4 && p.partial().enabled);
+    assert(p.partial().period.count() == 0 && p.received() == 3);
+    assert(p.feed(f.data() + 3, 1, on_record) == 1 && p.fields_ready() == 0 && p.received() == 0);
+    assert(records.size() == 1 && records[0].period == std::chrono::seconds{30} && !records[0].alarm);
+  }
+
+  // Chunks straddling frames, whole frames inside a chunk.
+  {
+    records.clear();
+    std::vector<uint8_t> stream;
+    for (uint8_t k = 0; k < 10; ++k) {
+      const auto f = frame(k, k & 1, k & 2, k * 3, 255 - k);
+      stream.insert(stream.end(), f.begin(), f.end());
+    }
+    parser p;
+    const size_t chunks[] = { 3, 9, 1, 2, 13, 6, 6 };
+    size_t at = 0;
+    for (size_t chunk : chunks) {
+      p.feed(stream.data() + at, chunk, on_record);
+      at += chunk;
+    }
+    assert(at == stream.size() && records.size() == 10);
+    for (uint8_t k = 0; k < 10; ++k) {
+      assert(records[k].id == k && records[k].enabled == bool(k & 1) && records[k].alarm == bool(k & 2));
+      assert(records[k].period.count() == k * 3 && records[k].level == 255 - k);
+    }
+  }
+
+  // reset drops the frame being received.
+  {
+    records.clear();
+    parser p;
+    const auto f = frame(1, false, true, 5, 9);
+    p.feed(f.data(), 2, on_record);
+    p.reset();
+    assert(p.feed(f.data(), f.size(), on_record) == 1 && records.size() == 1 && records[0].alarm);
+  }
+
+  // A lossy conversion still waits for every byte of its binary field.
+  {
+    const size_t alarm_order[] = { 1, 0, 2 };
+    const size_t alarm_needs[] = { 1, 3, 4 };
+    for (size_t i = 0; i < alarm_parser::fields; ++i) {
+      assert(alarm_parser::schedule().order[i] == alarm_order[i]);
+      assert(alarm_parser::schedule().needs[i] == alarm_needs[i]);
+    }
+
+    alarm_binary_representation raised{ 3, 0x0100, 50 };
+    config::sensor whole;
+    fill_all(raised, whole);
+    assert(whole.alarm);
+
+    std::vector<config::sensor> alarms;
+    alarm_parser p;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&raised);
+    for (size_t i = 0; i < sizeof(raised); ++i) {
+      p.feed(bytes + i, 1, [&](const config::sensor& c) { alarms.push_back(c); });
+      if (i == 1) { assert(p.fields_ready() == 1 && !p.partial().alarm); }
+    }
+    assert(alarms.size() == 1 && alarms[0].alarm && alarms[0].id == 3 && alarms[0].level == 50);
+  }
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/packed_layout.hpp>
+#include <annotate/translate.hpp>
+
+namespace config {
+
+  struct channel {
+    std::chrono::milliseconds pulse{0};
+    bool polarity{};
+  };
+
+  struct device {
+    channel a{}, b{};
+    uint8_t level{};
+    uint16_t timeout{300};
+  };
+
+  struct bank {
+    std::array<channel, 4> channels{};
+    uint8_t level{};
+  };
+
+}
+
+struct v1_frame {
+  uint8_t a_pulse;
+  uint8_t b_pulse;
+  struct alignas(1_byte) {
+    bool a                                    : 1_bits;
+    bool b                                    : 1_bits;
+    uint8_t reserved                          : 6_bits;
+  } polarities;
+  uint8_t level;
+};
+
+map_to(v1_frame, config::device,
+  ((a_pulse, a.pulse))
+  ((b_pulse, b.pulse))
+  ((polarities.a, a.polarity))
+  ((polarities.b, b.polarity))
+  ((level, level))
+);
+
+struct v2_frame {
+  uint16_t timeout;
+  uint16_t b_pulse;
+  uint16_t a_pulse;
+  bool b_polarity;
+  bool a_polarity;
+};
+
+map_to(v2_frame, config::device,
+  ((timeout, timeout))
+  ((b_pulse, b.pulse))
+  ((a_pulse, a.pulse))
+  ((b_polarity, b.polarity))
+  ((a_polarity, a.polarity))
+);
+
+packed_layout(device_packed, config::device,
+  ((level))
+  ((a.polarity))
+  ((a.pulse, 12_bits))
+  ((b.pulse, 12_bits))
+  ((b.polarity))
+);
+
+struct bank_v1_frame {
+  std::array<uint8_t, 4> pulses;
+  bit_column<4> polarities;
+  uint8_t level;
+};
+
+map_to(bank_v1_frame, config::bank,
+  ((pulses, channels, pulse))
+  ((polarities, channels, polarity))
+  ((level, level))
+);
+
+struct bank_v2_frame {
+  uint8_t level;
+  std::array<bool, 4> polarities;
+  std::array<uint16_t, 4> pulses;
+};
+
+map_to(bank_v2_frame, config::bank,
+  ((level, level))
+  ((polarities, channels, polarity))
+  ((pulses, channels, pulse))
+);
+
+using v1_to_v2 = translator<v1_frame, v2_frame, config::device>;
+using v2_to_v1 = translator<v2_frame, v1_frame, config::device>;
+using v1_to_packed = translator<v1_frame, device_packed, config::device>;
+
+static_assert(v1_to_v2::matched == 4, "level is not in v2, timeout not in v1");
+static_assert(v1_to_v2::sources[0] == v1_to_v2::no_field, "timeout");
+static_assert(v1_to_v2::sources[1] == 1 && v1_to_v2::sources[2] == 0, "by model field");
+static_assert(v1_to_v2::sources[3] == 3 && v1_to_v2::sources[4] == 2, "");
+static_assert(v2_to_v1::matched == 4 && v2_to_v1::sources[4] == v2_to_v1::no_field, "level");
+static_assert(v1_to_packed::matched == 5, "");
+static_assert(translator<bank_v1_frame, bank_v2_frame, config::bank>::matched == 3, "columns by column_name");
+
+int main() {
+  config::device d;
+  d.a.pulse = std::chrono::milliseconds{20};
+  d.b.pulse = std::chrono::milliseconds{255};
+  d.b.polarity = true;
+  d.level = 77;
+
+  v1_frame v1{};
+  update_all(v1, d);
+
+  // The same frame as through the model, fields v1 lacks at their default.
+  v2_frame direct;
+  std::memset(&direct, 0xAA, sizeof(direct));
+  v1_to_v2::translate(v1, direct);
+
+  config::device through;
+  fill_all(v1, through);
+  v2_frame expected{};
+  update_all(expected, through);
+  assert(std::memcmp(&direct, &expected, sizeof(v2_frame)) == 0);
+  assert(direct.timeout == 300 && direct.a_pulse == 20 && direct.b_pulse == 255 && direct.b_polarity);
+
+  // Back, level is not in v2 : the model default, as through the model.
+  v1_frame back{};
+  back.level = 5;
+  v2_to_v1::translate(direct, back);
+  assert(back.a_pulse == 20 && back.b_pulse == 255 && back.polarities.b && !back.polarities.a && back.level == 0);
+
+  // Into a generated layout.
+  device_packed packed{};
+  v1_to_packed::translate(&v1, &packed, 1);
+  config::device unpacked;
+  fill_all(packed, unpacked);
+  assert(unpacked.a.pulse == d.a.pulse && unpacked.b.pulse == d.b.pulse && unpacked.b.polarity);
+  assert(unpacked.level == 77 && unpacked.timeout == 300);
+
+  // Every field matches, the bits past them are still those of a fresh frame, not what the target held.
+  device_packed dirty;
+  std::memset(&dirty, 0xFF, sizeof(dirty));
+  v1_to_packed::translate(v1, dirty);
+  device_packed encoded{};
+  update_all(encoded, through);
+  assert(std::memcmp(&dirty, &encoded, sizeof(device_packed)) == 0);
+
+  // member_map_each columns pair with the column of the same model array and member.
+  config::bank b;
+  b.channels[0].pulse = std::chrono::milliseconds{1};
+  b.channels[3].pulse = std::chrono::milliseconds{200};
+  b.channels[2].polarity = true;
+  b.level = 9;
+  bank_v1_frame bank_v1{};
+  update_all(bank_v1, b);
+
+  bank_v2_frame bank_direct;
+  std::memset(&bank_direct, 0, sizeof(bank_direct));
+  translator<bank_v1_frame, bank_v2_frame, config::bank>::translate(bank_v1, bank_direct);
+  config::bank bank_through;
+  fill_all(bank_v1, bank_through);
+  bank_v2_frame bank_expected;
+  std::memset(&bank_expected, 0, sizeof(bank_expected));
+  update_all(bank_expected, bank_through);
+  assert(std::memcmp(&bank_direct, &bank_expected, sizeof(bank_v2_frame)) == 0);
+  assert(bank_direct.pulses[0] == 1 && bank_direct.pulses[3] == 200 && bank_direct.polarities[2]);
+
+  return 0;
+}
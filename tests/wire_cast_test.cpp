@@ -0,0 +1,36 @@
+#include <cassert>
+#include <cstdint>
+#include <array>
+#include <chrono>
+#include <annotate/wire_cast.hpp>
+
+int main() {
+  using namespace std::chrono;
+
+  static_assert(wire_cast<milliseconds>(uint8_t{200}) == milliseconds{200}, "wire integer to duration");
+  static_assert(wire_cast<uint8_t>(milliseconds{200}) == 200, "duration to wire integer");
+  static_assert(wire_cast<duration<int, std::deci>>(seconds{3}).count() == 30, "duration to duration");
+  static_assert(wire_cast<bool>(uint8_t{1}), "plain static_cast");
+
+  std::array<uint8_t, 4> wire{{1, 2, 3, 255}};
+  auto durations = wire_cast<std::array<milliseconds, 4>>(wire);
+  assert(durations[3] == milliseconds{255});
+  assert((wire_cast<std::array<uint8_t, 4>>(durations) == wire));
+
+  std::array<bool, 10> values{};
+  values[0] = values[7] = values[9] = true;
+  auto column = wire_cast<bit_column<10>>(values);
+  assert(column.bits[0] == 0x81 && column.bits[1] == 0x02);
+  assert((wire_cast<std::array<bool, 10>>(column) == values));
+
+  struct channel { bool polarity; milliseconds pulse; };
+  std::array<channel, 10> channels{};
+  fill_column(column, channels, [](auto& c) -> auto& { return c.polarity; });
+  assert(channels[7].polarity && !channels[8].polarity);
+
+  bit_column<10> back{};
+  update_column(back, channels, [](auto& c) -> auto& { return c.polarity; });
+  assert(back.bits == column.bits);
+
+  return 0;
+}
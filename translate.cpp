@@ -0,0 +1,155 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <boost/endian/buffers.hpp>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/byte_order.hpp>
+#include <annotate/translate.hpp>
+
+#include "./em510_binary.hpp"
+
+using namespace boost::endian;
+
+/**
+ * The successor module : the same channels, analog values first, every flag in one word, pulse durations on
+ * 16 bits big endian, and the timeouts of remote_io which the EM510 frame does not carry.
+ */
+struct em510_v2_binary_representation {
+
+  uint8_t ao_07_safety_value;
+  uint8_t ao_09_safety_value;
+  uint8_t ao_11_safety_value;
+  uint8_t reserved;
+
+  struct alignas(2_byte) {
+    bool triac_01_polarity                    : 1_bits;
+    bool triac_03_polarity                    : 1_bits;
+    bool triac_05_polarity                    : 1_bits;
+    bool relay_25_polarity                    : 1_bits;
+    bool relay_26_polarity                    : 1_bits;
+    bool relay_27_polarity                    : 1_bits;
+
+    bool triac_01_safety_value                : 1_bits;
+    bool triac_03_safety_value                : 1_bits;
+    bool triac_05_safety_value                : 1_bits;
+    bool relay_25_safety_value                : 1_bits;
+    bool relay_26_safety_value                : 1_bits;
+    bool relay_27_safety_value                : 1_bits;
+
+    bool ai_18                                : 1_bits;
+    bool ai_20                                : 1_bits;
+    bool ai_22                                : 1_bits;
+    bool ai_23                                : 1_bits;
+  } flags;
+
+  big_uint16_buf_t triac_01_pulse_duration;
+  big_uint16_buf_t triac_03_pulse_duration;
+  big_uint16_buf_t triac_05_pulse_duration;
+  big_uint16_buf_t relay_25_pulse_duration;
+  big_uint16_buf_t relay_26_pulse_duration;
+  big_uint16_buf_t relay_27_pulse_duration;
+
+  big_uint16_buf_t slc_timeout;
+  uint8_t deadtime_timeout;
+  uint8_t powerup_timeout;
+};
+
+map_to(em510_v2_binary_representation, config::ey_em510fxx,
+  ((ao_07_safety_value, ao_07))
+  ((ao_09_safety_value, ao_09))
+  ((ao_11_safety_value, ao_11))
+  ((flags.triac_01_polarity, triac_01.polarity))
+  ((flags.triac_03_polarity, triac_03.polarity))
+  ((flags.triac_05_polarity, triac_05.polarity))
+  ((flags.relay_25_polarity, relay_25.polarity))
+  ((flags.relay_26_polarity, relay_26.polarity))
+  ((flags.relay_27_polarity, relay_27.polarity))
+  ((flags.triac_01_safety_value, triac_01.safety_value))
+  ((flags.triac_03_safety_value, triac_03.safety_value))
+  ((flags.triac_05_safety_value, triac_05.safety_value))
+  ((flags.relay_25_safety_value, relay_25.safety_value))
+  ((flags.relay_26_safety_value, relay_26.safety_value))
+  ((flags.relay_27_safety_value, relay_27.safety_value))
+  ((flags.ai_18, ai_18))
+  ((flags.ai_20, ai_20))
+  ((flags.ai_22, ai_22))
+  ((flags.ai_23, ai_23))
+  ((triac_01_pulse_duration, triac_01.pulse_duration))
+  ((triac_03_pulse_duration, triac_03.pulse_duration))
+  ((triac_05_pulse_duration, triac_05.pulse_duration))
+  ((relay_25_pulse_duration, relay_25.pulse_duration))
+  ((relay_26_pulse_duration, relay_26.pulse_duration))
+  ((relay_27_pulse_duration, relay_27.pulse_duration))
+  ((slc_timeout, slc_timeout))
+  ((deadtime_timeout, deadtime_timeout))
+  ((powerup_timeout, powerup_timeout))
+);
+
+using to_v2 = translator<em510_binary_representation, em510_v2_binary_representation, config::ey_em510fxx>;
+using to_v1 = translator<em510_v2_binary_representation, em510_binary_representation, config::ey_em510fxx>;
+
+static_assert(to_v2::matched == 25, "every EM510 field has its place in the successor frame");
+static_assert(to_v2::sources[0] == 16 && to_v2::sources[19] == 0, "paired by model field, not by position");
+static_assert(to_v2::sources[25] == to_v2::no_field, "slc_timeout is not in the EM510 frame");
+static_assert(to_v1::matched == 25, "");
+
+config::ey_em510fxx frame_config(size_t k) {
+  config::ey_em510fxx cfg;
+  cfg.triac_01.pulse_duration = std::chrono::milliseconds{k % 256};
+  cfg.relay_27.pulse_duration = std::chrono::milliseconds{(k / 256) % 256};
+  cfg.triac_03.polarity = (k & 1) != 0;
+  cfg.relay_26.polarity = (k & 8) != 0;
+  cfg.ai_22 = (k & 2) != 0;
+  cfg.ao_09 = static_cast<uint8_t>(k * 7);
+  cfg.relay_25.safety_value = (k & 4) != 0;
+  return cfg;
+}
+
+int main(int argc, char** argv) {
+  const size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+
+  std::vector<em510_binary_representation> stored(count);
+  for (size_t k = 0; k < count; ++k) {
+    std::memset(&stored[k], 0, sizeof(em510_binary_representation));
+    update_all(stored[k], frame_config(k));
+  }
+
+  // Through the model, as the migration tool did.
+  std::vector<em510_v2_binary_representation> through_model(count);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t k = 0; k < count; ++k) {
+    config::ey_em510fxx cfg;
+    fill_all(stored[k], cfg);
+    std::memset(&through_model[k], 0, sizeof(em510_v2_binary_representation));
+    update_all(through_model[k], cfg);
+  }
+  auto model = std::chrono::steady_clock::now() - start;
+
+  std::vector<em510_v2_binary_representation> translated(count);
+  std::memset(translated.data(), 0, count * sizeof(em510_v2_binary_representation));
+  start = std::chrono::steady_clock::now();
+  to_v2::translate(stored.data(), translated.data(), count);
+  auto direct = std::chrono::steady_clock::now() - start;
+
+  assert(std::memcmp(through_model.data(), translated.data(), count * sizeof(em510_v2_binary_representation)) == 0);
+  assert(translated[0].slc_timeout.value() == 10 && translated[0].powerup_timeout == 1);
+
+  // And back.
+  std::vector<em510_binary_representation> back(count);
+  std::memset(back.data(), 0, count * sizeof(em510_binary_representation));
+  to_v1::translate(translated.data(), back.data(), count);
+  assert(std::memcmp(back.data(), stored.data(), count * sizeof(em510_binary_representation)) == 0);
+
+  using ns = std::chrono::nanoseconds;
+  std::cout << count << " frames, through the model : "
+            << std::chrono::duration_cast<ns>(model).count() / double(count) << " ns per frame, translated : "
+            << std::chrono::duration_cast<ns>(direct).count() / double(count) << " ns per frame" << std::endl;
+  return 0;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cassert>
+#include <cerrno>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/transport_pipeline.hpp>
+
+#include "./em510_binary.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+
+
+/**
+ * Opens the stand-in for the RS-485 bus : either a socketpair or a pty in raw mode.
+ * fds[0] is written by the pipeline, fds[1] is read by the fake bus.
+ */
+bool open_bus(bool use_pty, int fds[2]) {
+  if (!use_pty) {
+    return ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0;
+  }
+
+  int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0) { return false; }
+
+  int slave = ::open(::ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave < 0) { return false; }
+
+  termios tio;
+  ::tcgetattr(slave, &tio);
+  ::cfmakeraw(&tio);
+  ::tcsetattr(slave, TCSANOW, &tio);
+
+  fds[0] = master;
+  fds[1] = slave;
+  return true;
+}
+
+int main(int argc, char** argv) {
+
+  bool use_pty = (argc > 1) && (std::string(argv[1]) == "--pty");
+
+  int fds[2];
+  if (!open_bus(use_pty, fds)) {
+    std::cout << "could not open the bus stand-in" << std::endl;
+    return 1;
+  }
+
+  constexpr size_t batches = 64;
+  constexpr size_t batch_size = 100;
+  constexpr size_t frame_size = 1 + sizeof(em510_binary_representation);
+
+  std::vector<config_update<config::ey_em510fxx>> updates(batches * batch_size);
+  for (size_t i = 0; i < updates.size(); ++i) {
+    updates[i].address = static_cast<uint8_t>(i % 127);
+    updates[i].config.triac_01.pulse_duration = std::chrono::milliseconds{i % 256};
+    updates[i].config.triac_03.polarity = (i % 3) == 0;
+    updates[i].config.ai_23 = (i % 5) == 0;
+    updates[i].config.ao_09 = static_cast<uint8_t>(i);
+  }
+
+  // What was done before, strictly sequential, one frame at a time.
+  std::vector<char> expected;
+  for (auto& update : updates) {
+    em510_binary_representation h{};
+    update_all(h, update.config);
+    expected.push_back(static_cast<char>(update.address));
+    expected.insert(expected.end(), reinterpret_cast<char*>(&h), reinterpret_cast<char*>(&h) + sizeof(h));
+  }
+
+  std::vector<char> received;
+  std::thread fake_bus([&]() {
+    char chunk[4096];
+    while (received.size() < expected.size()) {
+      ssize_t n = ::read(fds[1], chunk, sizeof(chunk));
+      if (n <= 0) { break; }
+      received.insert(received.end(), chunk, chunk + n);
+    }
+  });
+
+  { frame_pipeline<em510_binary_representation, config::ey_em510fxx> pipeline{fds[0], batch_size};
+
+    for (size_t i = 0; i < batches; ++i) {
+      if (!pipeline.submit(updates.data() + i * batch_size, batch_size)) {
+        std::cout << "write failure : " << std::strerror(pipeline.error()) << std::endl;
+        return 1;
+      }
+    }
+
+    pipeline.flush();
+    assert(pipeline.frames_written() == updates.size());
+  }
+
+  fake_bus.join();
+  ::close(fds[0]);
+  ::close(fds[1]);
+
+  assert(received.size() == updates.size() * frame_size);
+  assert(received == expected);
+
+  // A batch has room for at least one frame, and there is at least one batch.
+  using pipeline_type = frame_pipeline<em510_binary_representation, config::ey_em510fxx>;
+  for (auto sizes : { std::make_pair(size_t{0}, size_t{2}), std::make_pair(size_t{1}, size_t{0}) }) {
+    try {
+      pipeline_type empty{-1, sizes.first, sizes.second};
+      assert(false);
+    } catch (const std::invalid_argument&) {
+    }
+  }
+
+  std::cout << "wrote " << updates.size() << " frames over " << (use_pty ? "a pty" : "a socketpair") << std::endl;
+
+  return 0;
+}
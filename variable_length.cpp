@@ -0,0 +1,188 @@
+#include <iostream>
+#include <utility>
+#include <cstring>
+#include <cassert>
+#include <array>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <annotate/literals.hpp>
+#include <annotate/member_mapping.hpp>
+#include <annotate/variable_length.hpp>
+#include <boost/fusion/include/adapt_struct.hpp>
+
+
+/*
+ * -------------------------- USER code Model domain -----------------------------------
+ */
+
+namespace config {
+
+  struct binary_output_config {
+
+    /**
+     * Duration of the Pulse signal (0 to 255ms)
+     */
+    std::chrono::milliseconds pulse_duration{0};
+
+    /**
+     * Determine channel polarity, which will be used to interpret further channel values.
+     */
+    bool polarity{};
+
+    /**
+     * Value used by the rio in case nothing provided
+     */
+    bool safety_value{};
+  };
+
+  struct remote_io {
+    /**
+     * Timeout that the device should wait for replies
+     */
+    std::chrono::seconds slc_timeout{10};
+
+    /**
+     * deadtime_timeout in 10th of seconds (1/10)
+     */
+    std::chrono::duration<int, std::deci> deadtime_timeout{10};
+
+    /**
+     * Time for the rio to startup
+     */
+    std::chrono::seconds powerup_timeout{1};
+  };
+
+  /**
+   * Remote IO EY-EM580FXXX : labelled relay module
+   */
+  struct ey_em580fxx : public remote_io {
+
+    ey_em580fxx() : remote_io() {}
+
+    /**
+     * Serial number as printed on the module
+     */
+    uint32_t serial_number{};
+
+    /**
+     * Label shown on the HMI, up to 32 characters
+     */
+    std::string label;
+
+    binary_output_config relay_01{};
+    binary_output_config relay_02{};
+  };
+
+}
+
+
+/*
+ * -------------------------- USER BINARY SERIALIZATION CODE -----------------------------------
+ */
+
+struct em580_wire {
+  leb128<uint32_t> serial_number;
+  length_prefixed<32> label;
+  leb128<uint16_t> slc_timeout;
+  leb128<uint16_t> deadtime_timeout;
+  leb128<uint16_t> powerup_timeout;
+  leb128<uint16_t> relay_01_pulse_duration;
+  leb128<uint16_t> relay_02_pulse_duration;
+  fixed<uint8_t> relay_01_polarity;
+  fixed<uint8_t> relay_02_polarity;
+};
+
+BOOST_FUSION_ADAPT_STRUCT(em580_wire,
+  serial_number,
+  label,
+  slc_timeout,
+  deadtime_timeout,
+  powerup_timeout,
+  relay_01_pulse_duration,
+  relay_02_pulse_duration,
+  relay_01_polarity,
+  relay_02_polarity)
+
+map_to(em580_wire, config::ey_em580fxx,
+  ((serial_number, serial_number))
+  ((label, label))
+  ((slc_timeout, slc_timeout))
+  ((deadtime_timeout, deadtime_timeout))
+  ((powerup_timeout, powerup_timeout))
+  ((relay_01_pulse_duration, relay_01.pulse_duration))
+  ((relay_02_pulse_duration, relay_02.pulse_duration))
+  ((relay_01_polarity, relay_01.polarity))
+  ((relay_02_polarity, relay_02.polarity))
+);
+
+
+int main(int argc, char** argv) {
+
+  static_assert(max_wire_size<em580_wire>() == 5 + (10 + 32) + 5 * 3 + 2, "bound of the EM580 frame");
+
+  std::vector<config::ey_em580fxx> modules(1000);
+  for (size_t i = 0; i < modules.size(); ++i) {
+    modules[i].serial_number = static_cast<uint32_t>(i * 104729);
+    modules[i].label = "Floor " + std::to_string(i / 40) + " - Room " + std::to_string(i % 40);
+    modules[i].relay_02.pulse_duration = std::chrono::milliseconds{i * 3};
+    modules[i].slc_timeout = std::chrono::seconds{i % 300};
+    modules[i].relay_01.polarity = (i % 3) == 0;
+  }
+  modules[7].label = std::string(100, 'x');
+
+  // Two pass : one allocation for the whole batch.
+  std::vector<uint8_t> batch;
+  auto offsets = encode_all<em580_wire>(modules.data(), modules.size(), batch);
+  assert(batch.size() == offsets.back());
+  assert(batch.capacity() == batch.size());
+
+  const uint8_t* in = batch.data();
+  for (size_t i = 0; i < modules.size(); ++i) {
+    assert(in == batch.data() + offsets[i]);
+    config::ey_em580fxx decoded;
+    assert((decode<em580_wire>(in, batch.data() + batch.size(), decoded)));
+    assert(decoded.serial_number == modules[i].serial_number);
+    assert(decoded.label == modules[i].label.substr(0, 32));
+    assert(decoded.relay_02.pulse_duration == modules[i].relay_02.pulse_duration);
+    assert(decoded.slc_timeout == modules[i].slc_timeout);
+    assert(decoded.relay_01.polarity == modules[i].relay_01.polarity);
+  }
+  assert(in == batch.data() + batch.size());
+
+  // Streaming : reserved once with the compile time bound.
+  std::vector<uint8_t> stream;
+  stream.reserve(modules.size() * max_wire_size<em580_wire>());
+  const uint8_t* reserved = stream.data();
+  for (auto& m : modules) { encode<em580_wire>(m, stream); }
+  assert(stream.data() == reserved);
+  assert(stream == batch);
+
+  // Truncated frames are refused.
+  const uint8_t* truncated = batch.data();
+  config::ey_em580fxx decoded;
+  assert(!(decode<em580_wire>(truncated, batch.data() + offsets[1] - 1, decoded)));
+
+  // The largest values round trip, longer or wider encodings are refused.
+  auto leb128_reads = [](auto field, std::vector<uint8_t> bytes) {
+    const uint8_t* in = bytes.data();
+    return field.read(in, bytes.data() + bytes.size());
+  };
+  assert(leb128_reads(leb128<uint16_t>{}, {0xFF, 0xFF, 0x03}));
+  assert(!leb128_reads(leb128<uint16_t>{}, {0xFF, 0xFF, 0x04}));
+  assert(!leb128_reads(leb128<uint16_t>{}, {0x80, 0x80, 0x80, 0x00}));
+  assert(leb128_reads(leb128<uint32_t>{}, {0xFF, 0xFF, 0xFF, 0xFF, 0x0F}));
+  assert(!leb128_reads(leb128<uint32_t>{}, {0xFF, 0xFF, 0xFF, 0xFF, 0x1F}));
+  assert(leb128_reads(leb128<uint64_t>{}, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}));
+  assert(!leb128_reads(leb128<uint64_t>{}, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02}));
+  assert(!leb128_reads(leb128<uint64_t>{}, {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00}));
+  leb128<uint32_t> widest;
+  const uint8_t largest[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+  const uint8_t* cursor = largest;
+  assert(widest.read(cursor, largest + sizeof(largest)) && widest.value == 0xFFFFFFFFu);
+
+  std::cout << modules.size() << " frames in " << batch.size() << " bytes, at most "
+            << max_wire_size<em580_wire>() << " bytes per frame" << std::endl;
+
+  return 0;
+}